@@ -57,6 +57,7 @@
 #include "f_wipe.h"
 
 #include "m_argv.h"
+#include "m_bench.h"
 #include "m_config.h"
 #include "m_controls.h"
 #include "m_misc.h"
@@ -163,6 +164,7 @@ int english_language = 0;
 int show_endoom   = 0;
 int level_brightness = 0; // [JN] Level brightness level
 int local_time    = 0; // [JN] Local time widget
+int render_threads = 1; // [JN] Threads drawing floors and ceilings
 
 // [JN] Automap specific variables.
 int automap_color   = 0;
@@ -393,7 +395,9 @@ void D_Display (void)
     // normal update
     if (!wipe)
     {
+        M_BenchBegin(bench_finishupdate);
         I_FinishUpdate ();  // page flip or blit buffer
+        M_BenchEnd(bench_finishupdate);
         return;
     }
 
@@ -415,7 +419,9 @@ void D_Display (void)
     // [JN] Don't call empty function
     // I_UpdateNoBlit ();
     M_Drawer ();        // menu is drawn even on top of wipes
+    M_BenchBegin(bench_finishupdate);
     I_FinishUpdate ();  // page flip or blit buffer
+    M_BenchEnd(bench_finishupdate);
     } while (!done);
 }
 
@@ -481,6 +487,7 @@ void D_BindVariables(void)
     M_BindIntVariable("show_diskicon",          &show_diskicon);
     M_BindIntVariable("screen_wiping",          &screen_wiping);
     M_BindIntVariable("show_endoom",            &show_endoom);
+    M_BindIntVariable("render_threads",         &render_threads);
 
     // Display
     M_BindIntVariable("screenblocks",           &screenblocks);
@@ -626,6 +633,18 @@ void D_DoomLoop (void)
 
     I_SetWindowTitle(gamedescription);
     I_GraphicsCheckCommandLine();
+
+    //!
+    // @category video
+    //
+    // Convert and upload all of the screen every frame, not only
+    // the parts that were drawn to since the last one.
+    //
+
+    // [JN] Every Doom drawer marks what it draws, so only the dirty
+    // part of the screen has to go to the texture.
+    dirtyrects = !M_ParmExists("-nodirtyrects");
+
     I_SetGrabMouseCallback(D_GrabMouseCallback);
     I_InitGraphics();
     EnableLoadingDisk();
@@ -669,7 +688,12 @@ void D_DoomLoop (void)
         }
 
         // move positional sounds
+        M_BenchBegin(bench_sound);
         S_UpdateSounds (players[consoleplayer].mo);
+        M_BenchEnd(bench_sound);
+
+        // [JN] Close per-phase timings of -benchmark.
+        M_BenchFrame();
     }
 }
 
@@ -2570,6 +2594,19 @@ void D_DoomMain (void)
 
     }
 
+    if (!p)
+    {
+        //!
+        // @arg <demo>
+        // @category demo
+        //
+        // Play back the demo named demo.lmp as -timedemo does, timing
+        // the game and renderer phases of every frame. Prints min,
+        // median, 99th percentile and max of each phase; see -benchout.
+        //
+    p = M_CheckParmWithArgs("-benchmark", 1);
+    }
+
     if (p)
     {
         char *uc_filename = strdup(myargv[p + 1]);
@@ -2906,6 +2943,14 @@ void D_DoomMain (void)
         D_DoomLoop ();      // never returns
     }
 
+    p = M_CheckParmWithArgs("-benchmark", 1);
+    if (p)
+    {
+        M_BenchStart(demolumpname);
+        G_TimeDemo (demolumpname);
+        D_DoomLoop ();      // never returns
+    }
+
     if (startloadgame >= 0)
     {
         M_StringCopy(file, P_SaveGameFile(startloadgame), sizeof(file));
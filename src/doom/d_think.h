@@ -58,6 +58,11 @@ typedef struct thinker_s
     struct thinker_s*   prev;
     struct thinker_s*   next;
     think_t function;
+    int                 pool;   // [JN] P_AllocThinker pool, -1 if none
+
+    // [JN] Links of the per class list, see P_RunThinkers.
+    struct thinker_s*   cprev;
+    struct thinker_s*   cnext;
 } thinker_t;
 
 
@@ -32,6 +32,7 @@
 #include "z_zone.h"
 #include "f_finale.h"
 #include "m_argv.h"
+#include "m_bench.h"
 #include "m_controls.h"
 #include "m_misc.h"
 #include "m_menu.h"
@@ -1241,7 +1242,9 @@ void G_Ticker (void)
     switch (gamestate) 
     { 
         case GS_LEVEL: 
+        M_BenchBegin(bench_ticker);
         P_Ticker (); 
+        M_BenchEnd(bench_ticker);
         ST_Ticker (); 
         AM_Ticker (); 
         HU_Ticker ();            
@@ -2797,6 +2800,9 @@ boolean G_CheckDemoStatus (void)
         timingdemo = false;
         demoplayback = false;
 
+        // [JN] -benchmark report goes before the summary below.
+        M_BenchReport();
+
         if (english_language)
         {
             I_Error ("timed %i gametics in %i realtics (%f fps)",
@@ -35,6 +35,7 @@
 #include "w_wad.h"
 #include "s_sound.h"
 #include "doomstat.h"
+#include "r_plane.h"  // [JN] rendered_visplanes, rendered_spans
 #include "st_stuff.h" // [JN] ST_HEIGHT
 #include "v_trans.h"  // [JN] Crosshair coloring
 #include "v_video.h"  // [JN] V_DrawPatch
@@ -159,6 +160,20 @@ static hu_stext_t w_message_time;
 static boolean  message_on_fps;
 static hu_stext_t w_message_fps;
 
+// [JN] Visplane counter (-devparm only)
+static boolean  message_on_vp;
+static hu_stext_t w_message_vp;
+
+// [JN] Span counter and plane drawing time (-devparm only)
+static boolean  message_on_sp;
+static hu_stext_t w_message_sp;
+static boolean  message_on_spt;
+static hu_stext_t w_message_spt;
+
+// [JN] Screen conversion time (-devparm only)
+static boolean  message_on_blt;
+static hu_stext_t w_message_blt;
+
 extern int showMessages;
 
 static boolean headsupactive = false;
@@ -743,6 +758,10 @@ void HU_Start(void)
     message_on_system = false;
     message_on_time = true; // [JN] Local time widget
     message_on_fps = true;  // [JN] FPS counter
+    message_on_vp = true;   // [JN] Visplane counter
+    message_on_sp = true;   // [JN] Span counter
+    message_on_spt = true;  // [JN] Plane drawing time
+    message_on_blt = true;  // [JN] Screen conversion time
     message_dontfuckwithme = false;
     message_nottobefuckedwith = false;
     chat_on = false;
@@ -773,6 +792,20 @@ void HU_Start(void)
     HUlib_initSText(&w_message_fps, 278 + (wide ? WIDE_DELTA*2 : 0), 20, 
                     HU_MSGHEIGHT, hu_font_gray, HU_FONTSTART, &message_on_fps);
 
+    // [JN] Create the visplane counter widget
+    HUlib_initSText(&w_message_vp, 278 + (wide ? WIDE_DELTA*2 : 0), 30, 
+                    HU_MSGHEIGHT, hu_font_gray, HU_FONTSTART, &message_on_vp);
+
+    // [JN] Create the span counter and plane drawing time widgets
+    HUlib_initSText(&w_message_sp, 278 + (wide ? WIDE_DELTA*2 : 0), 40, 
+                    HU_MSGHEIGHT, hu_font_gray, HU_FONTSTART, &message_on_sp);
+    HUlib_initSText(&w_message_spt, 278 + (wide ? WIDE_DELTA*2 : 0), 50, 
+                    HU_MSGHEIGHT, hu_font_gray, HU_FONTSTART, &message_on_spt);
+
+    // [JN] Create the screen conversion time widget
+    HUlib_initSText(&w_message_blt, 278 + (wide ? WIDE_DELTA*2 : 0), 60, 
+                    HU_MSGHEIGHT, hu_font_gray, HU_FONTSTART, &message_on_blt);
+
     // create the map title widget
     HUlib_initTextLine(&w_title, HU_TITLEX, (gamemission == jaguar ?
                                              HU_TITLEY_JAG :
@@ -897,6 +930,15 @@ void HU_Drawer(void)
     {
         // [JN] Draw FPS counter
         HUlib_drawSText(&w_message_fps);
+
+        // [JN] Draw visplane and span counters
+        if (devparm)
+        {
+            HUlib_drawSText(&w_message_vp);
+            HUlib_drawSText(&w_message_sp);
+            HUlib_drawSText(&w_message_spt);
+            HUlib_drawSText(&w_message_blt);
+        }
     }
     HUlib_drawIText(&w_chat);
 
@@ -1027,6 +1069,15 @@ void HU_Erase(void)
     {
         // [JN] Erase FPS counter
         HUlib_eraseSText(&w_message_fps);
+
+        // [JN] Erase visplane and span counters
+        if (devparm)
+        {
+            HUlib_eraseSText(&w_message_vp);
+            HUlib_eraseSText(&w_message_sp);
+            HUlib_eraseSText(&w_message_spt);
+            HUlib_eraseSText(&w_message_blt);
+        }
     }
     HUlib_eraseIText(&w_chat);
     HUlib_eraseTextLine(&w_title);
@@ -1041,6 +1092,10 @@ void HU_Ticker(void)
     struct tm *tm = localtime(&t);
     static char s[64];
     static char f[64];
+    static char v[64];
+    static char sp[64];
+    static char spt[64];
+    static char blt[64];
 
     // [JN] Compose the local time widget
     if (local_time && !vanillaparm)
@@ -1060,6 +1115,28 @@ void HU_Ticker(void)
     {
         M_snprintf(f, sizeof(f), "FPS: %d", real_fps);
         plr->message_fps = (f);
+
+        // [JN] Compose the visplane counter widget
+        if (devparm)
+        {
+            M_snprintf(v, sizeof(v), "VP: %d", rendered_visplanes);
+            HUlib_addMessageToSText(&w_message_vp, 0, v);
+            message_on_vp = true;
+
+            // [JN] Spans and plane drawing time in microseconds
+            M_snprintf(sp, sizeof(sp), "SP: %d", rendered_spans);
+            HUlib_addMessageToSText(&w_message_sp, 0, sp);
+            message_on_sp = true;
+
+            M_snprintf(spt, sizeof(spt), "SPT: %d", rendered_planetime);
+            HUlib_addMessageToSText(&w_message_spt, 0, spt);
+            message_on_spt = true;
+
+            // [JN] Screen conversion and upload time in microseconds
+            M_snprintf(blt, sizeof(blt), "BLT: %d", rendered_blittime);
+            HUlib_addMessageToSText(&w_message_blt, 0, blt);
+            message_on_blt = true;
+        }
     }
 
     // tick down message counter if message is up
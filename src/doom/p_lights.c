@@ -70,7 +70,7 @@ void P_SpawnFireFlicker (sector_t*	sector)
     // Nothing special about it during gameplay.
     sector->special = 0; 
 	
-    flick = Z_Malloc ( sizeof(*flick), PU_LEVSPEC, 0);
+    flick = P_AllocThinker (sizeof(*flick));
 
     P_AddThinker (&flick->thinker);
 
@@ -125,7 +125,7 @@ void P_SpawnLightFlash (sector_t*	sector)
     // nothing special about it during gameplay
     sector->special = 0;	
 	
-    flash = Z_Malloc ( sizeof(*flash), PU_LEVSPEC, 0);
+    flash = P_AllocThinker (sizeof(*flash));
 
     P_AddThinker (&flash->thinker);
 
@@ -183,7 +183,7 @@ P_SpawnStrobeFlash
     strobe_t*	flash;
     extern boolean canmodify;
 	
-    flash = Z_Malloc ( sizeof(*flash), PU_LEVSPEC, 0);
+    flash = P_AllocThinker (sizeof(*flash));
 
     P_AddThinker (&flash->thinker);
 
@@ -347,7 +347,7 @@ void P_SpawnGlowingLight(sector_t*	sector)
 {
     glow_t*	g;
 	
-    g = Z_Malloc( sizeof(*g), PU_LEVSPEC, 0);
+    g = P_AllocThinker (sizeof(*g));
 
     P_AddThinker(&g->thinker);
 
@@ -73,6 +73,9 @@ extern	thinker_t	thinkercap;
 void P_InitThinkers (void);
 void P_AddThinker (thinker_t* thinker);
 void P_RemoveThinker (thinker_t* thinker);
+void P_ClearThinkerPools (void);
+void* P_AllocThinker (size_t size);
+void P_FreeThinker (thinker_t* thinker);
 
 
 //
@@ -164,6 +167,7 @@ typedef struct
 
 extern intercept_t	intercepts[MAXINTERCEPTS];
 extern intercept_t*	intercept_p;
+extern int		tracecount;	// [JN] bumped when intercepts are refilled
 
 typedef boolean (*traverser_t) (intercept_t *in);
 
@@ -236,6 +240,9 @@ boolean P_CheckLineSide(mobj_t *actor, fixed_t x, fixed_t y);
 boolean P_TeleportMove (mobj_t* thing, fixed_t x, fixed_t y);
 void	P_SlideMove (mobj_t* mo);
 boolean P_CheckSight (mobj_t* t1, mobj_t* t2);
+
+// [JN] Bump when sector heights change, drops memoized sight checks.
+extern unsigned int sightmoves;
 void 	P_UseLines (player_t* player);
 
 boolean P_ChangeSector (sector_t* sector, boolean crunch);
@@ -269,13 +276,23 @@ void P_ApplyTorque(mobj_t *mo);     // killough 9/12/98
 // P_SETUP
 //
 extern byte*		rejectmatrix;	// for fast sight rejection
-extern long*		blockmaplump;	// offsets in blockmap are from here
-extern long*		blockmap;
+extern int32_t*	blockmaplump;	// offsets in blockmap are from here
+extern int32_t*	blockmap;
 extern int		bmapwidth;
 extern int		bmapheight;	// in mapblocks
 extern fixed_t		bmaporgx;
 extern fixed_t		bmaporgy;	// origin of block map
-extern mobj_t**		blocklinks;	// for thing chains
+
+// [JN] Things of a block, oldest first. Iterators go from the last
+// one, which is the order of the old linked lists.
+typedef struct
+{
+    mobj_t**	things;
+    int		numthings;
+    int		maxthings;
+} blocklinks_t;
+
+extern blocklinks_t*	blocklinks;	// for thing chains
 
 
 // [crispy] blinking key or skull in the status bar
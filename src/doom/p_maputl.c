@@ -24,9 +24,12 @@
 
 
 #include <stdlib.h>
+#include <string.h>
 
 
+#include "i_system.h"
 #include "m_bbox.h"
+#include "z_zone.h"
 
 #include "doomdef.h"
 #include "doomstat.h"
@@ -37,6 +40,7 @@
 #include "r_state.h"
 
 #include "crispy.h"
+#include "jn.h"
 
 //
 // P_AproxDistance
@@ -335,6 +339,72 @@ void P_LineOpening (line_t* linedef)
 //
 
 
+//
+// [JN] Blocks keep their things in arrays instead of linked lists,
+// which P_BlockThingsIterator walks without chasing pointers. Things
+// are appended when linked and unlinking keeps the order, so things
+// come out in the order the list heads had.
+//
+
+static void P_GrowBlockThings (blocklinks_t* block)
+{
+    mobj_t**	things;
+
+    block->maxthings = block->maxthings ? block->maxthings * 2 : 4;
+    things = Z_Malloc(block->maxthings * sizeof(*things), PU_LEVEL, NULL);
+
+    if (block->things)
+    {
+	memcpy(things, block->things, block->numthings * sizeof(*things));
+	Z_Free(block->things);
+    }
+
+    block->things = things;
+}
+
+// Index of a thing linked in block. Blocks hold a few things, and
+// moving ones are usually the last linked.
+static int P_FindBlockThing (blocklinks_t* block, mobj_t* thing)
+{
+    int		i;
+
+    for (i = block->numthings - 1; i >= 0; i--)
+    {
+	if (block->things[i] == thing)
+	    return i;
+    }
+
+    I_Error (english_language ?
+             "P_FindBlockThing: thing is not linked in block %i" :
+             "P_FindBlockThing: объект не связан с блоком %i",
+             thing->bmapblock);
+
+    return -1;
+}
+
+//
+// P_NextBlockThing
+// Thing to visit after mobj, once it has been moved while visited.
+// Same as following the old bnext link: the thing linked before it
+// in the block it is in now, or the one it had when it was unlinked.
+//
+
+static mobj_t* P_NextBlockThing (mobj_t* mobj, blocklinks_t** block, int* i)
+{
+    if (mobj->bmapblock < 0)
+    {
+	*i = -1;
+	return mobj->bnext;
+    }
+
+    *block = &blocklinks[mobj->bmapblock];
+    *i = P_FindBlockThing(*block, mobj);
+
+    return *i > 0 ? (*block)->things[--*i] : NULL;
+}
+
+
+
 //
 // P_UnsetThingPosition
 // Unlinks a thing from block map and sectors.
@@ -344,8 +414,8 @@ void P_LineOpening (line_t* linedef)
 //
 void P_UnsetThingPosition (mobj_t* thing)
 {
-    int		blockx;
-    int		blocky;
+    blocklinks_t*	block;
+    int		i;
 
     if ( ! (thing->flags & MF_NOSECTOR) )
     {
@@ -360,26 +430,19 @@ void P_UnsetThingPosition (mobj_t* thing)
 	    thing->subsector->sector->thinglist = thing->snext;
     }
 	
-    if ( ! (thing->flags & MF_NOBLOCKMAP) )
+    if ( ! (thing->flags & MF_NOBLOCKMAP) && thing->bmapblock >= 0)
     {
 	// inert things don't need to be in blockmap
 	// unlink from block map
-	if (thing->bnext)
-	    thing->bnext->bprev = thing->bprev;
-	
-	if (thing->bprev)
-	    thing->bprev->bnext = thing->bnext;
-	else
-	{
-	    blockx = (thing->x - bmaporgx)>>MAPBLOCKSHIFT;
-	    blocky = (thing->y - bmaporgy)>>MAPBLOCKSHIFT;
+	block = &blocklinks[thing->bmapblock];
+	i = P_FindBlockThing(block, thing);
 
-	    if (blockx>=0 && blockx < bmapwidth
-		&& blocky>=0 && blocky <bmapheight)
-	    {
-		blocklinks[blocky*bmapwidth+blockx] = thing->bnext;
-	    }
-	}
+	thing->bnext = i > 0 ? block->things[i-1] : NULL;
+	thing->bmapblock = -1;
+
+	block->numthings--;
+	memmove(&block->things[i], &block->things[i+1],
+	        (block->numthings - i) * sizeof(*block->things));
     }
 }
 
@@ -397,7 +460,7 @@ P_SetThingPosition (mobj_t* thing)
     sector_t*		sec;
     int			blockx;
     int			blocky;
-    mobj_t**		link;
+    blocklinks_t*	block;
 
     
     // link into subsector
@@ -431,18 +494,19 @@ P_SetThingPosition (mobj_t* thing)
 	    && blocky>=0
 	    && blocky < bmapheight)
 	{
-	    link = &blocklinks[blocky*bmapwidth+blockx];
-	    thing->bprev = NULL;
-	    thing->bnext = *link;
-	    if (*link)
-		(*link)->bprev = thing;
+	    thing->bmapblock = blocky*bmapwidth+blockx;
+	    block = &blocklinks[thing->bmapblock];
 
-	    *link = thing;
+	    if (block->numthings == block->maxthings)
+		P_GrowBlockThings(block);
+
+	    block->things[block->numthings++] = thing;
 	}
 	else
 	{
 	    // thing is off the map
-	    thing->bnext = thing->bprev = NULL;
+	    thing->bmapblock = -1;
+	    thing->bnext = NULL;
 	}
     }
 }
@@ -473,7 +537,7 @@ P_BlockLinesIterator
   boolean(*func)(line_t*) )
 {
     int			offset;
-    long*		list;
+    int32_t*		list;
     line_t*		ld;
 	
     if (x<0
@@ -523,6 +587,8 @@ P_BlockThingsIterator
   boolean(*func)(mobj_t*) )
 {
     mobj_t*		mobj;
+    blocklinks_t*	block;
+    int			i;
 	
     if ( x<0
 	 || y<0
@@ -532,13 +598,20 @@ P_BlockThingsIterator
 	return true;
     }
     
+    block = &blocklinks[y*bmapwidth+x];
+    i = block->numthings - 1;
+    mobj = i >= 0 ? block->things[i] : NULL;
 
-    for (mobj = blocklinks[y*bmapwidth+x] ;
-	 mobj ;
-	 mobj = mobj->bnext)
+    while (mobj)
     {
 	if (!func( mobj ) )
 	    return false;
+
+	// [JN] Still where it was, the next one is the one linked before.
+	if (i >= 0 && i < block->numthings && block->things[i] == mobj)
+	    mobj = i > 0 ? block->things[--i] : NULL;
+	else
+	    mobj = P_NextBlockThing(mobj, &block, &i);
     }
     return true;
 }
@@ -698,6 +771,62 @@ boolean PIT_AddThingIntercepts (mobj_t* thing)
 }
 
 
+//
+// [JN] Intercepts are visited nearest first, equal distances in the
+// order they were added, which is what the vanilla rescan of the whole
+// array for every intercept gives. A binary heap pops them in the same
+// order, so long traces that stop at the first wall don't pay for a
+// scan per intercept.
+//
+// tracecount changes whenever the intercepts array is refilled. A
+// traverser may start another trace (an attack in a pain state), after
+// which the vanilla scan of the new contents is kept.
+//
+
+int		tracecount;
+
+static intercept_t*	interceptheap[MAXINTERCEPTS + 1];
+static int		heapsize;
+
+static inline boolean P_InterceptBefore (intercept_t *a, intercept_t *b)
+{
+    return a->frac < b->frac || (a->frac == b->frac && a < b);
+}
+
+static void P_SiftIntercept (int i)
+{
+    intercept_t*	in = interceptheap[i];
+    int			child;
+
+    while ((child = 2 * i + 1) < heapsize)
+    {
+	if (child + 1 < heapsize
+	 && P_InterceptBefore(interceptheap[child + 1], interceptheap[child]))
+	    child++;
+
+	if (!P_InterceptBefore(interceptheap[child], in))
+	    break;
+
+	interceptheap[i] = interceptheap[child];
+	i = child;
+    }
+
+    interceptheap[i] = in;
+}
+
+static intercept_t *P_NextIntercept (void)
+{
+    intercept_t*	in = interceptheap[0];
+
+    if (--heapsize > 0)
+    {
+	interceptheap[0] = interceptheap[heapsize];
+	P_SiftIntercept(0);
+    }
+
+    return in;
+}
+
 //
 // P_TraverseIntercepts
 // Returns true if the traverser function returns true
@@ -709,23 +838,39 @@ P_TraverseIntercepts
   fixed_t	maxfrac )
 {
     int			count;
+    int			trace;
     fixed_t		dist;
     intercept_t*	scan;
     intercept_t*	in;
 	
     count = intercept_p - intercepts;
+    trace = tracecount;
     
     in = 0;			// shut up compiler warning
+
+    for (heapsize = 0 ; heapsize < count ; heapsize++)
+	interceptheap[heapsize] = &intercepts[heapsize];
+
+    for (scan = intercepts + count / 2 ; scan-- > intercepts ; )
+	P_SiftIntercept(scan - intercepts);
 	
     while (count--)
     {
-	dist = INT_MAX;
-	for (scan = intercepts ; scan<intercept_p ; scan++)
+	if (trace == tracecount)
+	{
+	    in = P_NextIntercept();
+	    dist = in->frac;
+	}
+	else
 	{
-	    if (scan->frac < dist)
+	    dist = INT_MAX;
+	    for (scan = intercepts ; scan<intercept_p ; scan++)
 	    {
-		dist = scan->frac;
-		in = scan;
+		if (scan->frac < dist)
+		{
+		    dist = scan->frac;
+		    in = scan;
+		}
 	    }
 	}
 	
@@ -916,6 +1061,7 @@ P_PathTraverse
     earlyout = (flags & PT_EARLYOUT) != 0;
 		
     validcount++;
+    tracecount++;
     intercept_p = intercepts;
 	
     if ( ((x1-bmaporgx)&(MAPBLOCKSIZE-1)) == 0)
@@ -717,8 +717,7 @@ P_SpawnMobjSafe
     state_t*	st;
     mobjinfo_t*	info;
 	
-    mobj = Z_Malloc (sizeof(*mobj), PU_LEVEL, NULL);
-    memset (mobj, 0, sizeof (*mobj));
+    mobj = P_AllocThinker (sizeof(*mobj));
     info = &mobjinfo[type];
 	
     mobj->type = type;
@@ -729,6 +728,7 @@ P_SpawnMobjSafe
     mobj->height = info->height;
     mobj->flags = info->flags;
     mobj->health = info->spawnhealth;
+    mobj->bmapblock = -1;   // [JN] not in a block until linked
 
     if (gameskill != sk_nightmare && gameskill != sk_ultranm)
 	mobj->reactiontime = info->reactiontime;
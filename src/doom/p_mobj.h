@@ -231,9 +231,12 @@ typedef struct mobj_s
     int			frame;	// might be ORed with FF_FULLBRIGHT
 
     // Interaction info, by BLOCKMAP.
-    // Links in blocks (if needed).
+    // [JN] Block the thing is linked in, -1 if none. Blocks keep their
+    // things in arrays, bnext is only set when the thing is unlinked:
+    // it is the thing that was linked before it, where an iteration
+    // that was visiting it carries on.
+    int			bmapblock;
     struct mobj_s*	bnext;
-    struct mobj_s*	bprev;
     
     struct subsector_s*	subsector;
 
@@ -338,7 +338,8 @@ static void saveg_read_mobj_t(mobj_t *str)
     str->bnext = saveg_readp();
 
     // struct mobj_s* bprev;
-    str->bprev = saveg_readp();
+    // [JN] No longer kept, P_SetThingPosition links the thing again.
+    saveg_readp();
 
     // struct subsector_s* subsector;
     str->subsector = saveg_readp();
@@ -456,7 +457,7 @@ static void saveg_write_mobj_t(mobj_t *str)
     saveg_writep(str->bnext);
 
     // struct mobj_s* bprev;
-    saveg_writep(str->bprev);
+    saveg_writep(NULL);
 
     // struct subsector_s* subsector;
     saveg_writep(str->subsector);
@@ -1644,6 +1645,8 @@ void P_UnArchiveWorld (void)
 	sec->specialdata = 0;
 	sec->soundtarget = 0;
     }
+
+    sightmoves++;		// [JN] new heights, see P_CheckSight
     
     // do lines
     for (i=0, li = lines ; i<numlines ; i++,li++)
@@ -1731,7 +1734,7 @@ void P_UnArchiveThinkers (void)
 	if (currentthinker->function.acp1 == (actionf_p1)P_MobjThinker)
 	    P_RemoveMobj ((mobj_t *)currentthinker);
 	else
-	    Z_Free (currentthinker);
+	    P_FreeThinker (currentthinker);
 
 	currentthinker = next;
     }
@@ -1748,9 +1751,11 @@ void P_UnArchiveThinkers (void)
 			
 	  case tc_mobj:
 	    saveg_read_pad();
-	    mobj = Z_Malloc (sizeof(*mobj), PU_LEVEL, NULL);
+	    mobj = P_AllocThinker (sizeof(*mobj));
             saveg_read_mobj_t(mobj);
 
+	    // [JN] not in a block until linked
+	    mobj->bmapblock = -1;
 	    P_SetThingPosition (mobj);
 	    mobj->info = &mobjinfo[mobj->type];
 
@@ -2026,7 +2031,7 @@ void P_UnArchiveSpecials (void)
 			
 	  case tc_ceiling:
 	    saveg_read_pad();
-	    ceiling = Z_Malloc (sizeof(*ceiling), PU_LEVEL, NULL);
+	    ceiling = P_AllocThinker (sizeof(*ceiling));
             saveg_read_ceiling_t(ceiling);
 	    ceiling->sector->specialdata = ceiling;
 
@@ -2039,7 +2044,7 @@ void P_UnArchiveSpecials (void)
 				
 	  case tc_door:
 	    saveg_read_pad();
-	    door = Z_Malloc (sizeof(*door), PU_LEVEL, NULL);
+	    door = P_AllocThinker (sizeof(*door));
             saveg_read_vldoor_t(door);
 	    door->sector->specialdata = door;
 	    door->thinker.function.acp1 = (actionf_p1)T_VerticalDoor;
@@ -2048,7 +2053,7 @@ void P_UnArchiveSpecials (void)
 				
 	  case tc_floor:
 	    saveg_read_pad();
-	    floor = Z_Malloc (sizeof(*floor), PU_LEVEL, NULL);
+	    floor = P_AllocThinker (sizeof(*floor));
             saveg_read_floormove_t(floor);
 	    floor->sector->specialdata = floor;
 	    floor->thinker.function.acp1 = (actionf_p1)T_MoveFloor;
@@ -2057,7 +2062,7 @@ void P_UnArchiveSpecials (void)
 				
 	  case tc_plat:
 	    saveg_read_pad();
-	    plat = Z_Malloc (sizeof(*plat), PU_LEVEL, NULL);
+	    plat = P_AllocThinker (sizeof(*plat));
             saveg_read_plat_t(plat);
 	    plat->sector->specialdata = plat;
 
@@ -2070,7 +2075,7 @@ void P_UnArchiveSpecials (void)
 				
 	  case tc_flash:
 	    saveg_read_pad();
-	    flash = Z_Malloc (sizeof(*flash), PU_LEVEL, NULL);
+	    flash = P_AllocThinker (sizeof(*flash));
             saveg_read_lightflash_t(flash);
 	    flash->thinker.function.acp1 = (actionf_p1)T_LightFlash;
 	    P_AddThinker (&flash->thinker);
@@ -2078,7 +2083,7 @@ void P_UnArchiveSpecials (void)
 				
 	  case tc_strobe:
 	    saveg_read_pad();
-	    strobe = Z_Malloc (sizeof(*strobe), PU_LEVEL, NULL);
+	    strobe = P_AllocThinker (sizeof(*strobe));
             saveg_read_strobe_t(strobe);
 	    strobe->thinker.function.acp1 = (actionf_p1)T_StrobeFlash;
 	    P_AddThinker (&strobe->thinker);
@@ -2086,7 +2091,7 @@ void P_UnArchiveSpecials (void)
 				
 	  case tc_glow:
 	    saveg_read_pad();
-	    glow = Z_Malloc (sizeof(*glow), PU_LEVEL, NULL);
+	    glow = P_AllocThinker (sizeof(*glow));
             saveg_read_glow_t(glow);
 	    glow->thinker.function.acp1 = (actionf_p1)T_Glow;
 	    P_AddThinker (&glow->thinker);
@@ -2094,7 +2099,7 @@ void P_UnArchiveSpecials (void)
         
       case tc_fireflicker:
         saveg_read_pad();
-        fireflicker = Z_Malloc(sizeof(*fireflicker), PU_LEVEL, NULL);
+        fireflicker = P_AllocThinker (sizeof(*fireflicker));
             saveg_read_fireflicker_t(fireflicker);
         fireflicker->thinker.function.acp1 = (actionf_p1)T_FireFlicker;
         P_AddThinker(&fireflicker->thinker);
@@ -21,6 +21,7 @@
 
 
 #include <math.h>
+#include <stdlib.h>
 
 #include "z_zone.h"
 
@@ -32,6 +33,8 @@
 #include "g_game.h"
 
 #include "i_system.h"
+#include "i_thread.h"
+#include "i_timer.h"
 #include "w_wad.h"
 
 #include "doomdef.h"
@@ -97,14 +100,14 @@ gameaction_t    gameaction;
 // Blockmap size.
 int		bmapwidth;
 int		bmapheight;	// size in mapblocks
-long*		blockmap;	// int for larger maps
+int32_t*	blockmap;	// int for larger maps
 // offsets in blockmap are from here
-long*		blockmaplump;		
+int32_t*	blockmaplump;
 // origin of block map
 fixed_t		bmaporgx;
 fixed_t		bmaporgy;
 // for thing chains
-mobj_t**	blocklinks;		
+blocklinks_t*	blocklinks;
 
 
 // REJECT
@@ -1345,10 +1348,92 @@ void P_LoadSideDefs (int lump)
 }
 
 // [crispy] taken from mbfsrc/P_SETUP.C:547-707, slightly adapted
-static void P_CreateBlockMap(void)
+// [JN] Split in two: P_BuildBlockMap only reads the level and uses
+// malloc, so it can run alongside the node loaders. It must not call
+// I_Error there, a failed allocation is left for P_PackBlockMap to
+// report on the calling thread, which also allocates the zone copy.
+//
+// [JN] The blocklists are counting sorted into one flat array, laid out
+// like the final blockmap, instead of growing a list for every block.
+// The blocks of every line are walked twice: first to count the lines
+// of each block, then, once the list offsets are known, to store them.
+// Lists come out as before, last line first.
+
+static int32_t *bmapbuild;  // blockmap built by P_BuildBlockMap
+static int bmapsize;        // its size in words
+static size_t bmapfailed;   // bytes P_BuildBlockMap couldn't allocate
+
+//
+// Walk the blocks of line i, from its first vertex to its second.
+// Counts the line into pos[] or, with fill set, stores it in front of
+// the position pos[] holds for the block.
+//
+
+static void P_LineBlocks(int i, int minx, int miny, int32_t *pos, boolean fill)
+{
+    unsigned tot = bmapwidth * bmapheight;
+    int x, y, adx, ady, bend;
+    int dx, dy, diff, b;
+
+    // starting coordinates
+    x = (lines[i].v1->x >> FRACBITS) - minx;
+    y = (lines[i].v1->y >> FRACBITS) - miny;
+
+    // x-y deltas
+    adx = lines[i].dx >> FRACBITS, dx = adx < 0 ? -1 : 1;
+    ady = lines[i].dy >> FRACBITS, dy = ady < 0 ? -1 : 1;
+
+    // difference in preferring to move across y (>0) instead of x (<0)
+    diff = !adx ? 1 : !ady ? -1 :
+    (((x >> MAPBTOFRAC) << MAPBTOFRAC) +
+    (dx > 0 ? MAPBLOCKUNITS-1 : 0) - x) * (ady = abs(ady)) * dx -
+    (((y >> MAPBTOFRAC) << MAPBTOFRAC) +
+    (dy > 0 ? MAPBLOCKUNITS-1 : 0) - y) * (adx = abs(adx)) * dy;
+
+    // starting block
+    b = (y >> MAPBTOFRAC)*bmapwidth + (x >> MAPBTOFRAC);
+
+    // ending block
+    bend = (((lines[i].v2->y >> FRACBITS) - miny) >> MAPBTOFRAC) *
+        bmapwidth + (((lines[i].v2->x >> FRACBITS) - minx) >> MAPBTOFRAC);
+
+    // delta for pointer when moving across y
+    dy *= bmapwidth;
+
+    // deltas for diff inside the loop
+    adx <<= MAPBTOFRAC;
+    ady <<= MAPBTOFRAC;
+
+    // Now we simply iterate block-by-block until we reach the end block.
+    while ((unsigned) b < tot)    // failsafe -- should ALWAYS be true
+    {
+        // Count the linedef, or add it to the list
+        if (fill)
+        bmapbuild[--pos[b]] = i;
+        else
+        pos[b]++;
+
+        // If we have reached the last block, exit
+        if (b == bend)
+        break;
+
+        // Move in either the x or y direction to the next block
+        if (diff < 0)
+        diff += ady, b += dx;
+        else
+        diff -= adx, b += dy;
+    }
+}
+
+static void P_BuildBlockMap(void)
 {
     register int i;
     fixed_t minx = INT_MAX, miny = INT_MAX, maxx = INT_MIN, maxy = INT_MIN;
+    unsigned tot;
+    int32_t *pos;
+    int ndx;
+
+    bmapfailed = 0;
 
     // First find limits of map
 
@@ -1370,130 +1455,84 @@ static void P_CreateBlockMap(void)
     bmaporgy = miny << FRACBITS;
     bmapwidth  = ((maxx-minx) >> MAPBTOFRAC) + 1;
     bmapheight = ((maxy-miny) >> MAPBTOFRAC) + 1;
+    tot = bmapwidth * bmapheight;
 
-    // Compute blockmap, which is stored as a 2d array of variable-sized lists.
-    //
-    // Pseudocode:
-    //
-    // For each linedef:
-    //
-    //   Map the starting and ending vertices to blocks.
-    //
-    //   Starting in the starting vertex's block, do:
-    //
-    //     Add linedef to current block's list, dynamically resizing it.
-    //
-    //     If current block is the same as the ending vertex's block, exit loop.
-    //
-    //     Move to an adjacent block by moving towards the ending block in
-    //     either the x or y direction, to the block which contains the linedef.
+    // Count the linedefs of every block.
 
-    {
-        typedef struct { int n, nalloc, *list; } bmap_t;  // blocklist structure
-        unsigned tot = bmapwidth * bmapheight;            // size of blockmap
-        bmap_t *bmap = calloc(sizeof *bmap, tot);         // array of blocklists
-        int x, y, adx, ady, bend;
+    pos = calloc(tot, sizeof(*pos));
 
-        for (i=0; i < numlines; i++)
-        {
-            int dx, dy, diff, b;
+    if (pos == NULL)
+    {
+        bmapfailed = sizeof(*pos) * tot;
+        return;
+    }
 
-        // starting coordinates
-        x = (lines[i].v1->x >> FRACBITS) - minx;
-        y = (lines[i].v1->y >> FRACBITS) - miny;
+    for (i=0; i < numlines; i++)
+        P_LineBlocks(i, minx, miny, pos, false);
 
-        // x-y deltas
-        adx = lines[i].dx >> FRACBITS, dx = adx < 0 ? -1 : 1;
-        ady = lines[i].dy >> FRACBITS, dy = ady < 0 ? -1 : 1;
+    // Lay out the blockmap. 4 header words, one offset word per block,
+    // then an empty list at tot+4 for the empty blocks to share, then
+    // a header word, the linedefs and a trailer word for every other
+    // block. pos[] is turned into the end of each block's linedefs.
 
-        // difference in preferring to move across y (>0) instead of x (<0)
-        diff = !adx ? 1 : !ady ? -1 :
-        (((x >> MAPBTOFRAC) << MAPBTOFRAC) +
-        (dx > 0 ? MAPBLOCKUNITS-1 : 0) - x) * (ady = abs(ady)) * dx -
-        (((y >> MAPBTOFRAC) << MAPBTOFRAC) +
-        (dy > 0 ? MAPBLOCKUNITS-1 : 0) - y) * (adx = abs(adx)) * dy;
+    ndx = tot + 6;
 
-        // starting block, and pointer to its blocklist structure
-        b = (y >> MAPBTOFRAC)*bmapwidth + (x >> MAPBTOFRAC);
+    for (i = 0; i < tot; i++)
+        if (pos[i])
+            ndx += pos[i] + 2;
 
-        // ending block
-        bend = (((lines[i].v2->y >> FRACBITS) - miny) >> MAPBTOFRAC) *
-            bmapwidth + (((lines[i].v2->x >> FRACBITS) - minx) >> MAPBTOFRAC);
+    bmapsize = ndx;
+    bmapbuild = malloc(sizeof(*bmapbuild) * bmapsize);
 
-        // delta for pointer when moving across y
-        dy *= bmapwidth;
+    if (bmapbuild == NULL)
+    {
+        bmapfailed = sizeof(*bmapbuild) * bmapsize;
+        free(pos);
+        return;
+    }
 
-        // deltas for diff inside the loop
-        adx <<= MAPBTOFRAC;
-        ady <<= MAPBTOFRAC;
+    bmapbuild[0] = minx;
+    bmapbuild[1] = miny;
+    bmapbuild[2] = bmapwidth;
+    bmapbuild[3] = bmapheight;
+    bmapbuild[tot + 4] = 0;
+    bmapbuild[tot + 5] = -1;
 
-        // Now we simply iterate block-by-block until we reach the end block.
-        while ((unsigned) b < tot)    // failsafe -- should ALWAYS be true
+    for (i = 0, ndx = tot + 6; i < tot; i++)
+        if (pos[i])
         {
-            // Increase size of allocated list if necessary
-            if (bmap[b].n >= bmap[b].nalloc)
-                bmap[b].list = crispy_realloc(bmap[b].list,
-               (bmap[b].nalloc = bmap[b].nalloc ?
-				bmap[b].nalloc*2 : 8)*sizeof*bmap->list);
-
-            // Add linedef to end of list
-            bmap[b].list[bmap[b].n++] = i;
-
-            // If we have reached the last block, exit
-            if (b == bend)
-            break;
-
-            // Move in either the x or y direction to the next block
-            if (diff < 0)
-            diff += ady, b += dx;
-            else
-            diff -= adx, b += dy;
+            bmapbuild[i + 4] = ndx;
+            bmapbuild[ndx] = 0;                 // header
+            ndx += pos[i] + 1;
+            bmapbuild[ndx] = -1;                // trailer
+            pos[i] = ndx++;
         }
-    }
-
-    // Compute the total size of the blockmap.
-    //
-    // Compression of empty blocks is performed by reserving two offset words
-    // at tot and tot+1.
-    //
-    // 4 words, unused if this routine is called, are reserved at the start.
+        else
+        bmapbuild[i + 4] = tot + 4;
 
-    {
-        int count = tot+6;  // we need at least 1 word per block, plus reserved's
+    // Store the linedefs, filling every list from its end.
 
-        for (i = 0; i < tot; i++)
-            if (bmap[i].n)
-                count += bmap[i].n + 2; // 1 header word + 1 trailer word + blocklist
+    for (i=0; i < numlines; i++)
+        P_LineBlocks(i, minx, miny, pos, true);
 
-        // Allocate blockmap lump with computed count
-        blockmaplump = Z_Malloc(sizeof(*blockmaplump) * count, PU_LEVEL, 0);
-    }
+    free(pos);
+}
 
-    // Now compress the blockmap.
+static void P_PackBlockMap(void)
+{
+    if (bmapfailed)
     {
-        int ndx = tot += 4;         // Advance index to start of linedef lists
-        bmap_t *bp = bmap;          // Start of uncompressed blockmap
-
-        blockmaplump[ndx++] = 0;    // Store an empty blockmap list at start
-        blockmaplump[ndx++] = -1;   // (Used for compression)
-
-        for (i = 4; i < tot; i++, bp++)
-            if (bp->n)                                      // Non-empty blocklist
-            {
-                blockmaplump[blockmaplump[i] = ndx++] = 0;  // Store index & header
-                do
-                blockmaplump[ndx++] = bp->list[--bp->n];    // Copy linedef list
-                while (bp->n);
-                blockmaplump[ndx++] = -1;                   // Store trailer
-                free(bp->list);                             // Free linedef list
-            }
-            else            // Empty blocklist: point to reserved empty blocklist
-            blockmaplump[i] = tot;
-
-        free(bmap);    // Free uncompressed blockmap
-    }
+        I_Error(english_language ?
+                "P_CreateBlockMap: failed to allocate %i bytes" :
+                "P_CreateBlockMap: ошибка обнаружения %i байт",
+                (int) bmapfailed);
     }
 
+    blockmaplump = Z_Malloc(sizeof(*blockmaplump) * bmapsize, PU_LEVEL, 0);
+    memcpy(blockmaplump, bmapbuild, sizeof(*blockmaplump) * bmapsize);
+    free(bmapbuild);
+    bmapbuild = NULL;
+
     // [crispy] copied over from P_LoadBlockMap()
     {
         int count = sizeof(*blocklinks) * bmapwidth * bmapheight;
@@ -1542,7 +1581,7 @@ boolean P_LoadBlockMap (int lump)
     for (i=4; i<count; i++)
     {
 	short t = SHORT(wadblockmaplump[i]);
-	blockmaplump[i] = (t == -1) ? -1l : (int32_t) t & 0xffff;
+	blockmaplump[i] = (t == -1) ? -1 : (int32_t) t & 0xffff;
     }
     
     Z_Free(wadblockmaplump);
@@ -1868,6 +1907,254 @@ mapformat_t P_CheckMapFormat (int lumpnum)
     return format;
 }
 
+
+//
+// [JN] Level loading stages. A stage runs once every stage in its deps
+// mask is done; stages that become ready together run on the thread
+// pool at once. The zone, the WAD cache and I_Error aren't thread safe,
+// so only one stage of a batch may use them (zone set), and it is put
+// first to run on the calling thread. Other stages only use malloc and
+// must not call I_Error. Stage times are kept for the -devparm log of
+// P_SetupLevel.
+//
+
+typedef enum
+{
+    ls_blockmap,        // BLOCKMAP lump
+    ls_vertexes,
+    ls_sectors,
+    ls_sidedefs,
+    ls_linedefs,
+    ls_buildblockmap,   // blocklists from the lines, if no usable lump
+    ls_nodes,           // subsectors, nodes and segs
+    ls_packblockmap,    // zone copy of the built blockmap
+    ls_grouplines,
+    ls_slimetrails,
+    ls_seglengths,
+    ls_reject,
+    NUMLOADSTAGES
+} loadstage_t;
+
+#define LS(stage) (1 << (stage))
+
+typedef struct
+{
+    const char *name;
+    void (*func)(void);
+    int deps;
+    boolean zone;
+} loadstep_t;
+
+static int loadlumpnum;
+static mapformat_t loadformat;
+static boolean loadvalidblockmap;
+static uint64_t loadtimes[NUMLOADSTAGES];
+
+static void P_StageBlockMap (void)
+{
+    // [crispy] (re-)create BLOCKMAP if necessary
+    loadvalidblockmap = P_LoadBlockMap(loadlumpnum + ML_BLOCKMAP);
+}
+
+static void P_StageVertexes (void)
+{
+    P_LoadVertexes(loadlumpnum + ML_VERTEXES);
+}
+
+static void P_StageSectors (void)
+{
+    P_LoadSectors(loadlumpnum + ML_SECTORS);
+}
+
+static void P_StageSideDefs (void)
+{
+    P_LoadSideDefs(loadlumpnum + ML_SIDEDEFS);
+}
+
+static void P_StageLineDefs (void)
+{
+    if (loadformat & HEXEN)
+	P_LoadLineDefs_Hexen(loadlumpnum + ML_LINEDEFS);
+    else
+    P_LoadLineDefs(loadlumpnum + ML_LINEDEFS);
+}
+
+static void P_StageBuildBlockMap (void)
+{
+    if (!loadvalidblockmap)
+    P_BuildBlockMap();
+}
+
+static void P_StageNodes (void)
+{
+    if (loadformat & (ZDBSPX | ZDBSPZ))
+	P_LoadNodes_ZDBSP(loadlumpnum + ML_NODES, loadformat & ZDBSPZ);
+    else
+    if (loadformat & DEEPBSP)
+    {
+	P_LoadSubsectors_DeePBSP(loadlumpnum + ML_SSECTORS);
+	P_LoadNodes_DeePBSP(loadlumpnum + ML_NODES);
+	P_LoadSegs_DeePBSP(loadlumpnum + ML_SEGS);
+    }
+    else
+    {
+    P_LoadSubsectors(loadlumpnum + ML_SSECTORS);
+    P_LoadNodes(loadlumpnum + ML_NODES);
+    P_LoadSegs(loadlumpnum + ML_SEGS);
+    }
+}
+
+static void P_StagePackBlockMap (void)
+{
+    if (!loadvalidblockmap)
+    P_PackBlockMap();
+}
+
+static void P_StageReject (void)
+{
+    P_LoadReject(loadlumpnum + ML_REJECT);
+}
+
+static const loadstep_t loadsteps[NUMLOADSTAGES] =
+{
+    { "blockmap",    P_StageBlockMap,       0,                                  true  },
+    { "vertexes",    P_StageVertexes,       LS(ls_blockmap),                    true  },
+    { "sectors",     P_StageSectors,        LS(ls_vertexes),                    true  },
+    { "sidedefs",    P_StageSideDefs,       LS(ls_sectors),                     true  },
+    { "linedefs",    P_StageLineDefs,       LS(ls_sidedefs),                    true  },
+    { "blocklists",  P_StageBuildBlockMap,  LS(ls_linedefs),                    false },
+    { "nodes",       P_StageNodes,          LS(ls_linedefs),                    true  },
+    { "packblocks",  P_StagePackBlockMap,   LS(ls_buildblockmap),               true  },
+    { "grouplines",  P_GroupLines,          LS(ls_nodes) | LS(ls_packblockmap), true  },
+    { "slimetrails", P_RemoveSlimeTrails,   LS(ls_nodes),                       false },
+    { "seglengths",  P_SegLengths,          LS(ls_slimetrails),                 false },
+    { "reject",      P_StageReject,         LS(ls_grouplines),                  true  },
+};
+
+static int P_StageDeps (int stage)
+{
+    int deps = loadsteps[stage].deps;
+
+    // ZDBSP nodes add vertexes and move the lines onto the new array,
+    // the blocklists must be built from the lines before that.
+    if (stage == ls_nodes && (loadformat & (ZDBSPX | ZDBSPZ)))
+    {
+        deps |= LS(ls_buildblockmap);
+    }
+
+    return deps;
+}
+
+static void P_RunLoadStage (void *data, int index)
+{
+    loadstage_t stage = ((loadstage_t *) data)[index];
+    uint64_t start = I_GetTimeUS();
+
+    loadsteps[stage].func();
+    loadtimes[stage] = I_GetTimeUS() - start;
+}
+
+static void P_RunLoadStages (void)
+{
+    // batch[0] is kept for the zone stage, which I_RunParallel
+    // runs on this thread
+    loadstage_t batch[NUMLOADSTAGES + 1];
+    int done = 0;
+    int i, n;
+    boolean zone;
+
+    while (done != LS(NUMLOADSTAGES) - 1)
+    {
+        for (i = 0, n = 1, zone = false; i < NUMLOADSTAGES; i++)
+        {
+            if ((done & LS(i)) || (P_StageDeps(i) & ~done))
+            {
+                continue;
+            }
+
+            if (loadsteps[i].zone)
+            {
+                if (zone)
+                {
+                    continue;
+                }
+
+                zone = true;
+                batch[0] = i;
+            }
+            else
+            {
+                batch[n++] = i;
+            }
+        }
+
+        if (zone)
+        {
+            I_RunParallel(P_RunLoadStage, batch, n);
+        }
+        else
+        {
+            I_RunParallel(P_RunLoadStage, batch + 1, n - 1);
+        }
+
+        for (i = zone ? 0 : 1; i < n; i++)
+        {
+            done |= LS(batch[i]);
+        }
+    }
+}
+
+
+//
+// P_LevelLumpName
+// Name of the map marker lump, lumpname must hold 9 chars.
+//
+static void P_LevelLumpName (char *lumpname, int episode, int map)
+{
+    if ( gamemode == commercial)
+    {
+	if (map<10)
+	    DEH_snprintf(lumpname, 9, "map0%i", map);
+	else
+	    DEH_snprintf(lumpname, 9, "map%i", map);
+    }
+    else
+    {
+	lumpname[0] = 'E';
+	lumpname[1] = '0' + episode;
+	lumpname[2] = 'M';
+	lumpname[3] = '0' + map;
+	lumpname[4] = 0;
+    }
+}
+
+
+//
+// P_PrefetchLevel
+// [JN] Lets the OS start reading the map lumps of the next level in the
+// background while the intermission screen is up.
+//
+void P_PrefetchLevel (int episode, int map)
+{
+    char	lumpname[9];
+    lumpindex_t	lumps[ML_BLOCKMAP+1];
+    int		lumpnum;
+    int		i;
+
+    P_LevelLumpName(lumpname, episode, map);
+
+    lumpnum = W_CheckNumForName(lumpname);
+
+    if (lumpnum < 0)
+	return;
+
+    for (i = 0; i <= ML_BLOCKMAP; i++)
+	lumps[i] = lumpnum + i;
+
+    W_PrefetchLumps(lumps, ML_BLOCKMAP+1);
+}
+
+
 //
 // P_SetupLevel
 //
@@ -1882,7 +2169,8 @@ P_SetupLevel
     char	lumpname[9];
     int		lumpnum;
     mapformat_t	crispy_mapformat;
-    boolean crispy_validblockmap;
+    uint64_t	loadstart = I_GetTimeUS();
+    uint64_t	precachetime;
 	
     totalkills = totalitems = totalsecret = wminfo.maxfrags = 0;
     wminfo.partime = 180;
@@ -1899,29 +2187,18 @@ P_SetupLevel
     S_Start ();			
 
     Z_FreeTags (PU_LEVEL, PU_PURGELEVEL-1);
+    P_ClearThinkerPools ();	// [JN] their slabs went with the level
 
     // UNUSED W_Profile ();
     P_InitThinkers ();
 
+    sightmoves++;			// [JN] new sectors, see P_CheckSight
+
     // if working with a devlopment map, reload it
     W_Reload ();
 
     // find map name
-    if ( gamemode == commercial)
-    {
-	if (map<10)
-	    DEH_snprintf(lumpname, 9, "map0%i", map);
-	else
-	    DEH_snprintf(lumpname, 9, "map%i", map);
-    }
-    else
-    {
-	lumpname[0] = 'E';
-	lumpname[1] = '0' + episode;
-	lumpname[2] = 'M';
-	lumpname[3] = '0' + map;
-	lumpname[4] = 0;
-    }
+    P_LevelLumpName(lumpname, episode, map);
 
     lumpnum = W_GetNumForName (lumpname);
 	
@@ -1942,44 +2219,11 @@ P_SetupLevel
     // [crispy] check and log map and nodes format
     crispy_mapformat = P_CheckMapFormat(lumpnum);
 
-    // note: most of this ordering is important	
-    crispy_validblockmap = P_LoadBlockMap (lumpnum+ML_BLOCKMAP); // [crispy] (re-)create BLOCKMAP if necessary
-    P_LoadVertexes (lumpnum+ML_VERTEXES);
-    P_LoadSectors (lumpnum+ML_SECTORS);
-    P_LoadSideDefs (lumpnum+ML_SIDEDEFS);
-
-    if (crispy_mapformat & HEXEN)
-	P_LoadLineDefs_Hexen (lumpnum+ML_LINEDEFS);
-    else
-    P_LoadLineDefs (lumpnum+ML_LINEDEFS);
-
-    // [crispy] (re-)create BLOCKMAP if necessary
-    if (!crispy_validblockmap)
-    P_CreateBlockMap();
-
-    if (crispy_mapformat & (ZDBSPX | ZDBSPZ))
-	P_LoadNodes_ZDBSP (lumpnum+ML_NODES, crispy_mapformat & ZDBSPZ);
-    else
-    if (crispy_mapformat & DEEPBSP)
-    {
-	P_LoadSubsectors_DeePBSP (lumpnum+ML_SSECTORS);
-	P_LoadNodes_DeePBSP (lumpnum+ML_NODES);
-	P_LoadSegs_DeePBSP (lumpnum+ML_SEGS);
-    }
-    else
-    {
-    P_LoadSubsectors (lumpnum+ML_SSECTORS);
-    P_LoadNodes (lumpnum+ML_NODES);
-    P_LoadSegs (lumpnum+ML_SEGS);
-    }
+    // note: most of this ordering is important, see loadsteps
+    loadlumpnum = lumpnum;
+    loadformat = crispy_mapformat;
+    P_RunLoadStages();
 
-    P_GroupLines ();
-    P_LoadReject (lumpnum+ML_REJECT);
-    
-    // [crispy] remove slime trails
-    P_RemoveSlimeTrails();
-    // [crispy] fix long wall wobble
-    P_SegLengths();
     // [crispy] blinking key or skull in the status bar
     memset(st_keyorskull, 0, sizeof(st_keyorskull));
 
@@ -2013,8 +2257,27 @@ P_SetupLevel
     //	UNUSED P_ConnectSubsectors ();
 
     // preload graphics
+    precachetime = I_GetTimeUS();
     if (precache)
 	R_PrecacheLevel ();
+    precachetime = I_GetTimeUS() - precachetime;
+
+    // [JN] Log how long the level took to load, stage by stage with
+    // -devparm. Stages of a batch overlap, so they add up to more than
+    // the wall clock time.
+    fprintf(stderr, english_language ?
+            "P_SetupLevel: %s loaded in %d ms\n" :
+            "P_SetupLevel: %s загружен за %d мс\n",
+            lumpname, (int) ((I_GetTimeUS() - loadstart) / 1000));
+
+    if (devparm)
+    {
+	for (i = 0; i < NUMLOADSTAGES; i++)
+	    fprintf(stderr, "  %-12s %8d us\n",
+	            loadsteps[i].name, (int) loadtimes[i]);
+
+	fprintf(stderr, "  %-12s %8d us\n", "precache", (int) precachetime);
+    }
 
     //printf ("free memory: 0x%x\n", Z_FreeMemory());
 
@@ -33,6 +33,9 @@ P_SetupLevel
   int		playermask,
   skill_t	skill);
 
+// Reads ahead the map lumps of a level about to be loaded.
+void P_PrefetchLevel (int episode, int map);
+
 // Called by startup code.
 void P_Init (void);
 
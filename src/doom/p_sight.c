@@ -26,6 +26,7 @@
 
 // State.
 #include "r_state.h"
+#include "doomstat.h"
 
 #include "jn.h"
 
@@ -42,6 +43,43 @@ fixed_t		t2y;
 
 int		sightcounts[2];
 
+//
+// [JN] Memo of BSP line of sight checks. A monster often checks the
+// same target more than once in a tic (A_Look finds the player, then
+// A_Chase of its see state checks again for a missile attack). The
+// result only depends on where both mobjs are and on sector heights,
+// so it is kept for the rest of the tic unless one of them moves or
+// any plane does. sightmoves is bumped by T_MovePlane and whenever
+// sector heights are set otherwise (level setup, savegame loading).
+//
+
+#define SIGHTMEMO	4096		// power of two
+
+typedef struct
+{
+    mobj_t*	t1;
+    mobj_t*	t2;
+    fixed_t	x1, y1, z1, h1;
+    fixed_t	x2, y2, z2, h2;
+    int		tic;			// leveltime of the check
+    unsigned int moves;			// sightmoves of the check
+    boolean	result;
+} sightmemo_t;
+
+static sightmemo_t	sightmemo[SIGHTMEMO];
+
+unsigned int		sightmoves = 1;	// 0 marks unused entries
+
+static sightmemo_t *P_SightMemo (mobj_t *t1, mobj_t *t2)
+{
+    unsigned int	hash;
+
+    hash = (unsigned int) ((uintptr_t) t1 >> 4) * 0x9E3779B1u;
+    hash ^= (unsigned int) ((uintptr_t) t2 >> 4);
+
+    return &sightmemo[(hash ^ (hash >> 16)) & (SIGHTMEMO - 1)];
+}
+
 
 //
 // P_DivlineSide
@@ -312,6 +350,7 @@ P_CheckSight
     int		pnum;
     int		bytenum;
     int		bitnum;
+    sightmemo_t*	memo;
     
     // First check for trivial rejection.
 
@@ -335,6 +374,18 @@ P_CheckSight
     // Now look from eyes of t1 to any part of t2.
     sightcounts[1]++;
 
+    memo = P_SightMemo(t1, t2);
+
+    if (memo->moves == sightmoves && memo->tic == leveltime
+     && memo->t1 == t1 && memo->t2 == t2
+     && memo->x1 == t1->x && memo->y1 == t1->y
+     && memo->z1 == t1->z && memo->h1 == t1->height
+     && memo->x2 == t2->x && memo->y2 == t2->y
+     && memo->z2 == t2->z && memo->h2 == t2->height)
+    {
+	return memo->result;
+    }
+
     validcount++;
 	
     sightzstart = t1->z + t1->height - (t1->height>>2);
@@ -349,7 +400,21 @@ P_CheckSight
     strace.dy = t2->y - t1->y;
 
     // the head node is the last node output
-    return P_CrossBSPNode (numnodes-1);	
+    memo->t1 = t1;
+    memo->t2 = t2;
+    memo->x1 = t1->x;
+    memo->y1 = t1->y;
+    memo->z1 = t1->z;
+    memo->h1 = t1->height;
+    memo->x2 = t2->x;
+    memo->y2 = t2->y;
+    memo->z2 = t2->z;
+    memo->h2 = t2->height;
+    memo->tic = leveltime;
+    memo->moves = sightmoves;
+    memo->result = P_CrossBSPNode (numnodes-1);
+
+    return memo->result;
 }
 
 
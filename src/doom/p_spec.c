@@ -52,7 +52,6 @@
 // [JN] Файл со строчкой о найденном секрете.
 #include "rd_lang.h"
 
-#include "r_swirl.h"
 #include "crispy.h"
 #include "jn.h"
 
@@ -208,10 +207,6 @@ void P_InitPicAnims (void)
 	lastanim->speed = animdefs[i].speed;
 	lastanim++;
     }
-	
-    // [JN] Not needed in "-vanilla", since there is no swirling flats
-    if (!vanillaparm)
-    R_InitDistortedFlats();
 }
 
 
@@ -1483,7 +1478,7 @@ int EV_DoDonut(line_t*	line)
             }
 
 	    //	Spawn rising slime
-	    floor = Z_Malloc (sizeof(*floor), PU_LEVSPEC, 0);
+	    floor = P_AllocThinker (sizeof(*floor));
 	    P_AddThinker (&floor->thinker);
 	    s2->specialdata = floor;
 	    floor->thinker.function.acp1 = (actionf_p1) T_MoveFloor;
@@ -1497,7 +1492,7 @@ int EV_DoDonut(line_t*	line)
 	    floor->floordestheight = s3_floorheight;
 	    
 	    //	Spawn lowering donut-hole
-	    floor = Z_Malloc (sizeof(*floor), PU_LEVSPEC, 0);
+	    floor = P_AllocThinker (sizeof(*floor));
 	    P_AddThinker (&floor->thinker);
 	    s1->specialdata = floor;
 	    floor->thinker.function.acp1 = (actionf_p1) T_MoveFloor;
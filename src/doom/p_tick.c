@@ -20,6 +20,8 @@
 
 
 
+#include <string.h>
+
 #include "z_zone.h"
 #include "p_local.h"
 
@@ -31,7 +33,7 @@ int	leveltime;
 
 //
 // THINKERS
-// All thinkers should be allocated by Z_Malloc
+// All thinkers should be allocated by P_AllocThinker
 // so they can be operated on uniformly.
 // The actual structures will vary in size,
 // but the first element must be thinker_t.
@@ -42,13 +44,58 @@ int	leveltime;
 // Both the head and tail of the thinker list.
 thinker_t	thinkercap;
 
+// [JN] Every thinker is also on one list of its class, in the same
+// order as on the main list, so P_RunThinkers can run the mobjs and
+// the specials without stepping over each other. Removed thinkers
+// wait on th_delete until they are freed.
+typedef enum
+{
+    th_mobj,
+    th_misc,
+    th_delete,
+    NUMTHCLASS
+} thinkerclass_t;
+
+static thinker_t	thinkerclasscap[NUMTHCLASS];
+
+// Thinker of the class list being run, or the one before it if it
+// got unlinked meanwhile. The walk goes on from its cnext.
+static thinker_t*	classcursor;
+
 
 //
 // P_InitThinkers
 //
 void P_InitThinkers (void)
 {
+    int		i;
+
     thinkercap.prev = thinkercap.next  = &thinkercap;
+
+    for (i = 0; i < NUMTHCLASS; i++)
+	thinkerclasscap[i].cprev = thinkerclasscap[i].cnext = &thinkerclasscap[i];
+
+    classcursor = NULL;
+}
+
+
+static void P_LinkThinkerClass (thinker_t* thinker, thinkerclass_t class)
+{
+    thinker_t*	cap = &thinkerclasscap[class];
+
+    cap->cprev->cnext = thinker;
+    thinker->cnext = cap;
+    thinker->cprev = cap->cprev;
+    cap->cprev = thinker;
+}
+
+static void P_UnlinkThinkerClass (thinker_t* thinker)
+{
+    if (thinker == classcursor)
+	classcursor = thinker->cprev;
+
+    thinker->cnext->cprev = thinker->cprev;
+    thinker->cprev->cnext = thinker->cnext;
 }
 
 
@@ -64,6 +111,9 @@ void P_AddThinker (thinker_t* thinker)
     thinker->next = &thinkercap;
     thinker->prev = thinkercap.prev;
     thinkercap.prev = thinker;
+
+    P_LinkThinkerClass(thinker,
+	thinker->function.acp1 == (actionf_p1)P_MobjThinker ? th_mobj : th_misc);
 }
 
 
@@ -77,19 +127,154 @@ void P_RemoveThinker (thinker_t* thinker)
 {
   // FIXME: NOP.
   thinker->function.acv = (actionf_v)(-1);
+
+  P_UnlinkThinkerClass(thinker);
+  P_LinkThinkerClass(thinker, th_delete);
+}
+
+
+
+//
+// THINKER POOLS
+// [JN] Thinkers of the same size are carved out of shared slabs of
+// cache line aligned slots, and removed ones go back onto a free list
+// of their pool, instead of each one going through the zone. Slabs are
+// PU_LEVEL and go away with the rest of the level.
+//
+
+#define THINKERALIGN	64
+#define SLABSLOTS	64
+#define NUMTHINKERPOOLS	16	// slots up to 16 * THINKERALIGN bytes
+
+typedef struct poolslot_s
+{
+    struct poolslot_s*	next;
+} poolslot_t;
+
+static poolslot_t*	thinkerpools[NUMTHINKERPOOLS];
+
+
+//
+// P_ClearThinkerPools
+// Forgets all slots, called once the level zone has been freed.
+//
+void P_ClearThinkerPools (void)
+{
+    memset(thinkerpools, 0, sizeof(thinkerpools));
+}
+
+
+//
+// P_AllocThinker
+// Returns a cleared block for a thinker of the given size.
+// Must be released with P_FreeThinker.
+//
+void* P_AllocThinker (size_t size)
+{
+    int		pool = (size + THINKERALIGN - 1) / THINKERALIGN - 1;
+    size_t	slotsize = (pool + 1) * THINKERALIGN;
+    poolslot_t*	slot;
+    byte*	slab;
+    thinker_t*	thinker;
+    int		i;
+
+    if (pool >= NUMTHINKERPOOLS)
+    {
+	thinker = Z_Malloc (size, PU_LEVEL, NULL);
+	memset (thinker, 0, size);
+	thinker->pool = -1;
+	return thinker;
+    }
+
+    if (!thinkerpools[pool])
+    {
+	// new slab, aligned by hand
+	slab = Z_Malloc (SLABSLOTS * slotsize + THINKERALIGN - 1, PU_LEVEL, NULL);
+	slab = (byte *) (((uintptr_t) slab + THINKERALIGN - 1)
+	                 & ~(uintptr_t) (THINKERALIGN - 1));
+
+	for (i = SLABSLOTS - 1; i >= 0; i--)
+	{
+	    slot = (poolslot_t *) (slab + i * slotsize);
+	    slot->next = thinkerpools[pool];
+	    thinkerpools[pool] = slot;
+	}
+    }
+
+    slot = thinkerpools[pool];
+    thinkerpools[pool] = slot->next;
+
+    thinker = (thinker_t *) slot;
+    memset (thinker, 0, size);
+    thinker->pool = pool;
+
+    return thinker;
+}
+
+
+//
+// P_FreeThinker
+// Puts a thinker's slot back onto its pool.
+//
+void P_FreeThinker (thinker_t* thinker)
+{
+    int		pool = thinker->pool;
+    poolslot_t*	slot;
+
+    if (pool < 0)
+    {
+	Z_Free (thinker);
+	return;
+    }
+
+    slot = (poolslot_t *) thinker;
+    slot->next = thinkerpools[pool];
+    thinkerpools[pool] = slot;
 }
 
 
 
 //
-// P_AllocateThinker
-// Allocates memory and adds a new thinker at the end of the list.
+// P_RunThinkerClass
+// Runs the thinkers of one class in list order, including ones
+// added while the list is being run.
 //
-void P_AllocateThinker (thinker_t*	thinker)
+static void P_RunThinkerClass (thinkerclass_t class)
 {
+    thinker_t*	cap = &thinkerclasscap[class];
+    thinker_t*	currentthinker;
+
+    for (currentthinker = cap->cnext ;
+	 currentthinker != cap ;
+	 currentthinker = classcursor->cnext)
+    {
+	classcursor = currentthinker;
+
+	if (currentthinker->function.acp1)
+	    currentthinker->function.acp1 (currentthinker);
+    }
+
+    classcursor = NULL;
 }
 
 
+//
+// P_FreeRemovedThinkers
+//
+static void P_FreeRemovedThinkers (void)
+{
+    thinker_t*	cap = &thinkerclasscap[th_delete];
+    thinker_t*	currentthinker;
+
+    while ((currentthinker = cap->cnext) != cap)
+    {
+	currentthinker->next->prev = currentthinker->prev;
+	currentthinker->prev->next = currentthinker->next;
+	P_UnlinkThinkerClass(currentthinker);
+	P_FreeThinker(currentthinker);
+    }
+}
+
 
 //
 // P_RunThinkers
@@ -101,19 +286,14 @@ void P_RunThinkers (void)
     // [JN] Prevent dropped item from jittering on moving platforms.
     // For single player only, really not safe for internal demos.
     // See: https://github.com/bradharding/doomretro/issues/501
+    // All mobjs think first, then the specials, each from the list of
+    // its class instead of two walks over all thinkers.
     if (singleplayer)
     {
-        currentthinker = thinkercap.next;
-        while (currentthinker != &thinkercap)
-        {
-        {
-            if (currentthinker->function.acp1)
-            if (currentthinker->function.acp1 == (actionf_p1)P_MobjThinker)
-            currentthinker->function.acp1 (currentthinker);
-                nextthinker = currentthinker->next;
-        }
-        currentthinker = nextthinker;
-        }
+        P_RunThinkerClass(th_mobj);
+        P_FreeRemovedThinkers();
+        P_RunThinkerClass(th_misc);
+        return;
     }
 
     currentthinker = thinkercap.next;
@@ -125,24 +305,14 @@ void P_RunThinkers (void)
             nextthinker = currentthinker->next;
 	    currentthinker->next->prev = currentthinker->prev;
 	    currentthinker->prev->next = currentthinker->next;
-	    Z_Free(currentthinker);
+	    P_UnlinkThinkerClass(currentthinker);
+	    P_FreeThinker(currentthinker);
 	}
 	else
 	{
-        // [JN] Prevent dropped item from jittering on moving platforms.
-        if (singleplayer)
-        {
-            if (currentthinker->function.acp1)
-                if (currentthinker->function.acp1 != (actionf_p1)P_MobjThinker)
-            currentthinker->function.acp1 (currentthinker);
-                nextthinker = currentthinker->next;
-        }
-        else
-        {
             if (currentthinker->function.acp1)
             currentthinker->function.acp1 (currentthinker);
                 nextthinker = currentthinker->next;
-        }
 	}
 	currentthinker = nextthinker;
     }
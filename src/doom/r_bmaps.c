@@ -17,38 +17,34 @@
 
 
 #include "doomdef.h"
+#include "z_zone.h"
 #include "doomstat.h"
 #include "d_main.h"
 #include "r_bmaps.h"
 #include "jn.h"
 
 
-// Floors and ceilings:
-int bmapflatnum1, bmapflatnum2, bmapflatnum3, bmapflatnum4;
-
-// Walls:
-int bmaptexture01, bmaptexture02, bmaptexture03, bmaptexture04, bmaptexture05,
-    bmaptexture06, bmaptexture07, bmaptexture08, bmaptexture09, bmaptexture10,
-    bmaptexture11, bmaptexture12, bmaptexture13, bmaptexture14, bmaptexture15,
-    bmaptexture16, bmaptexture17, bmaptexture18, bmaptexture19, bmaptexture20,
-    bmaptexture21, bmaptexture22, bmaptexture23, bmaptexture24, bmaptexture25,
-    bmaptexture26, bmaptexture27, bmaptexture28, bmaptexture29, bmaptexture30,
-    bmaptexture31, bmaptexture32, bmaptexture33, bmaptexture34, bmaptexture35,
-    bmaptexture36, bmaptexture37, bmaptexture38, bmaptexture39, bmaptexture40,
-    bmaptexture41, bmaptexture42, bmaptexture43, bmaptexture44, bmaptexture45,
-    bmaptexture46, bmaptexture47, bmaptexture48, bmaptexture49, bmaptexture50,
-    bmaptexture51, bmaptexture52, bmaptexture53, bmaptexture54, bmaptexture55,
-    bmaptexture56, bmaptexture57, bmaptexture58, bmaptexture59, bmaptexture60,
-    bmaptexture61, bmaptexture62, bmaptexture63, bmaptexture64, bmaptexture65,
-    bmaptexture66, bmaptexture67, bmaptexture68, bmaptexture69, bmaptexture70,
-    bmaptexture71, bmaptexture72, bmaptexture73, bmaptexture74, bmaptexture75,
-    bmaptexture76, bmaptexture77, bmaptexture78, bmaptexture79, bmaptexture80,
-    bmaptexture81, bmaptexture82, bmaptexture83, bmaptexture84, bmaptexture85,
-    bmaptexture86, bmaptexture87, bmaptexture88, bmaptexture89, bmaptexture90,
-    bmaptexture91, bmaptexture92, bmaptexture93;
-
-// Terminator:
-int bmap_terminator;
+extern int numtextures;
+extern int numflats;
+
+brightmap_t**       texturebrightmap;
+flatbrightmap_t**   flatbrightmap;
+
+
+//
+// [JN] Table setters. Later calls win, like the order of checks in the
+// old per-seg comparison chains did.
+//
+
+static void R_BrightmapTexture (char *name, brightmap_t *brightmap)
+{
+    texturebrightmap[R_TextureNumForName(name)] = brightmap;
+}
+
+static void R_BrightmapFlat (char *name, flatbrightmap_t *brightmap)
+{
+    flatbrightmap[R_FlatNumForName(name)] = brightmap;
+}
 
 //
 // [JN] Lookup and init all the textures for brightmapping.
@@ -57,6 +53,21 @@ int bmap_terminator;
 
 void R_InitBrightmappedTextures(void)
 {
+    int i;
+
+    texturebrightmap = Z_Malloc(numtextures * sizeof(*texturebrightmap), PU_STATIC, 0);
+    flatbrightmap = Z_Malloc(numflats * sizeof(*flatbrightmap), PU_STATIC, 0);
+
+    for (i = 0 ; i < numtextures ; i++)
+    {
+        texturebrightmap[i] = scalelight;
+    }
+
+    for (i = 0 ; i < numflats ; i++)
+    {
+        flatbrightmap[i] = zlight;
+    }
+
     // Texture lookup. There are many strict definitions,
     // for example, no need to lookup Doom 1 textures in TNT.
 
@@ -66,21 +77,18 @@ void R_InitBrightmappedTextures(void)
     if (gamemission == jaguar)
     {
         // Flats
-        bmapflatnum4 = R_FlatNumForName("GATE5");
+        R_BrightmapFlat("GATE5", fullbright_orangeyellow_floor);
 
         // Textures
 
         // Red only:
-        bmaptexture39 = R_TextureNumForName("EXITSIGN");
-        bmaptexture08 = R_TextureNumForName("SW2WOOD");
-        bmaptexture17 = R_TextureNumForName("SW2GSTON");
-        bmaptexture34 = R_TextureNumForName("SW2HOT");
+        R_BrightmapTexture("EXITSIGN", fullbright_redonly);
+        R_BrightmapTexture("SW2WOOD", fullbright_redonly);
+        R_BrightmapTexture("SW2GSTON", fullbright_redonly);
+        R_BrightmapTexture("SW2HOT", fullbright_redonly);
 
         // Bright tan:
-        bmaptexture88 = R_TextureNumForName("SW2GARG");
-
-        // Apply terminator
-        bmap_terminator = R_TextureNumForName("BIGDOOR2");
+        R_BrightmapTexture("SW2GARG", fullbright_brighttan);
 
         // Don't look up any farther
         return;
@@ -90,10 +98,10 @@ void R_InitBrightmappedTextures(void)
     //  Flats and ceilings (available in all games)
     // -------------------------------------------------------
     {
-        bmapflatnum1 = R_FlatNumForName("CONS1_1");
-        bmapflatnum2 = R_FlatNumForName("CONS1_5");
-        bmapflatnum3 = R_FlatNumForName("CONS1_7");
-        bmapflatnum4 = R_FlatNumForName("GATE6");
+        R_BrightmapFlat("CONS1_1", fullbright_notgrayorbrown_floor);
+        R_BrightmapFlat("CONS1_5", fullbright_notgrayorbrown_floor);
+        R_BrightmapFlat("CONS1_7", fullbright_notgrayorbrown_floor);
+        R_BrightmapFlat("GATE6", fullbright_orangeyellow_floor);
     }
 
     // -------------------------------------------------------
@@ -102,24 +110,24 @@ void R_InitBrightmappedTextures(void)
     if (gamemode != shareware)
     {
         // Red only
-        bmaptexture08 = R_TextureNumForName("SW2WOOD");
-        bmaptexture09 = R_TextureNumForName("WOOD4");
-        bmaptexture11 = R_TextureNumForName("SLADSKUL");
-        bmaptexture16 = R_TextureNumForName("SW2BLUE");
-        bmaptexture17 = R_TextureNumForName("SW2GSTON");
-        bmaptexture23 = R_TextureNumForName("WOODGARG");
-        bmaptexture34 = R_TextureNumForName("EXITSTON");
+        R_BrightmapTexture("SW2WOOD", fullbright_redonly);
+        R_BrightmapTexture("WOOD4", fullbright_redonly);
+        R_BrightmapTexture("SLADSKUL", fullbright_redonly);
+        R_BrightmapTexture("SW2BLUE", fullbright_redonly);
+        R_BrightmapTexture("SW2GSTON", fullbright_redonly);
+        R_BrightmapTexture("WOODGARG", fullbright_redonly);
+        R_BrightmapTexture("EXITSTON", fullbright_redonly);
 
         // Green only 1
-        bmaptexture73 = R_TextureNumForName("SW2VINE");
+        R_BrightmapTexture("SW2VINE", fullbright_greenonly1);
 
         // Bright tan
-        bmaptexture86 = R_TextureNumForName("SW2SATYR");
-        bmaptexture87 = R_TextureNumForName("SW2LION");
-        bmaptexture88 = R_TextureNumForName("SW2GARG");
+        R_BrightmapTexture("SW2SATYR", fullbright_brighttan);
+        R_BrightmapTexture("SW2LION", fullbright_brighttan);
+        R_BrightmapTexture("SW2GARG", fullbright_brighttan);
 
         // Red only 2
-        bmaptexture93 = R_TextureNumForName("SW2HOT");
+        R_BrightmapTexture("SW2HOT", fullbright_redonly2);
     }
 
     // -------------------------------------------------------
@@ -128,7 +136,7 @@ void R_InitBrightmappedTextures(void)
     if (gamemode == registered || gamemode == retail)
     {
         // Red only
-        bmaptexture10 = R_TextureNumForName("WOODSKUL");
+        R_BrightmapTexture("WOODSKUL", fullbright_redonly);
     }
 
     // -------------------------------------------------------
@@ -137,19 +145,22 @@ void R_InitBrightmappedTextures(void)
     if (gamemode == shareware || gamemode == registered || gamemode == retail 
     ||  gamemode == pressbeta)
     {
+        // Red only (Doom 2: green only, see below)
+        R_BrightmapTexture("SW2STON2", fullbright_redonly);
+
         // Not gray
-        bmaptexture30 = R_TextureNumForName("PLANET1");
-        bmaptexture38 = R_TextureNumForName("LITEBLU2");
+        R_BrightmapTexture("PLANET1", fullbright_notgray);
+        R_BrightmapTexture("LITEBLU2", fullbright_notgray);
 
         // Not gray or brown
-        bmaptexture40 = R_TextureNumForName("COMP2");
-        bmaptexture41 = R_TextureNumForName("COMPUTE2");
-        bmaptexture43 = R_TextureNumForName("COMPUTE1");
-        bmaptexture44 = R_TextureNumForName("COMPUTE3");
+        R_BrightmapTexture("COMP2", fullbright_notgrayorbrown);
+        R_BrightmapTexture("COMPUTE2", fullbright_notgrayorbrown);
+        R_BrightmapTexture("COMPUTE1", fullbright_notgrayorbrown);
+        R_BrightmapTexture("COMPUTE3", fullbright_notgrayorbrown);
 
         // Red only 1
-        bmaptexture89 = R_TextureNumForName("TEKWALL2");
-        bmaptexture90 = R_TextureNumForName("TEKWALL5");
+        R_BrightmapTexture("TEKWALL2", fullbright_redonly1);
+        R_BrightmapTexture("TEKWALL5", fullbright_redonly1);
     }
 
     // -------------------------------------------------------
@@ -157,7 +168,7 @@ void R_InitBrightmappedTextures(void)
     // -------------------------------------------------------
     if (sgl_loaded || sgl_compat_loaded)
     {
-        bmaptexture92 = R_TextureNumForName("SIGIL");
+        R_BrightmapTexture("SIGIL", fullbright_redonly);
     }
 
     // -------------------------------------------------------
@@ -166,37 +177,38 @@ void R_InitBrightmappedTextures(void)
     if (gamemode == commercial)
     {
         // Red only
-        bmaptexture01 = R_TextureNumForName("SW1STARG");
-        bmaptexture02 = R_TextureNumForName("SW2MARB");
-        bmaptexture06 = R_TextureNumForName("SW2PANEL");
-        bmaptexture12 = R_TextureNumForName("SW1BRIK");
-        bmaptexture14 = R_TextureNumForName("SW1MET2");
-        bmaptexture18 = R_TextureNumForName("SW2ROCK");
-        bmaptexture19 = R_TextureNumForName("SW2STON6");
-        bmaptexture20 = R_TextureNumForName("SW2ZIM");
-        bmaptexture25 = R_TextureNumForName("SW1BRN1");
-        bmaptexture26 = R_TextureNumForName("SW1STON2");
-        bmaptexture91 = R_TextureNumForName("METAL3");
+        R_BrightmapTexture("SW1STARG", fullbright_redonly);
+        R_BrightmapTexture("SW2MARB", fullbright_redonly);
+        R_BrightmapTexture("SW2PANEL", fullbright_redonly);
+        R_BrightmapTexture("SW1BRIK", fullbright_redonly);
+        R_BrightmapTexture("SW1MET2", fullbright_redonly);
+        R_BrightmapTexture("SW2ROCK", fullbright_redonly);
+        R_BrightmapTexture("SW2STON6", fullbright_redonly);
+        R_BrightmapTexture("SW2ZIM", fullbright_redonly);
+        R_BrightmapTexture("SW1BRN1", fullbright_redonly);
+        R_BrightmapTexture("SW1STON2", fullbright_redonly);
+        R_BrightmapTexture("METAL3", fullbright_redonly);
 
         // Not gray or brown
-        bmaptexture35 = R_TextureNumForName("SILVER2");
-        bmaptexture42 = R_TextureNumForName("SILVER3");
+        R_BrightmapTexture("SILVER2", fullbright_notgrayorbrown);
+        R_BrightmapTexture("SILVER3", fullbright_notgrayorbrown);
 
         // Green only 1
-        bmaptexture45 = R_TextureNumForName("SW2MOD1");
-        bmaptexture58 = R_TextureNumForName("SPCDOOR3");
-        bmaptexture66 = R_TextureNumForName("SW2TEK");
-        bmaptexture67 = R_TextureNumForName("SW2BRIK");
-        bmaptexture71 = R_TextureNumForName("SW2MET2");
-        bmaptexture74 = R_TextureNumForName("PIPEWAL1");
-        bmaptexture75 = R_TextureNumForName("TEKLITE2");
+        R_BrightmapTexture("SW2MOD1", fullbright_greenonly1);
+        R_BrightmapTexture("SPCDOOR3", fullbright_greenonly1);
+        R_BrightmapTexture("SW2TEK", fullbright_greenonly1);
+        R_BrightmapTexture("SW2BRIK", fullbright_greenonly1);
+        R_BrightmapTexture("SW2MET2", fullbright_greenonly1);
+        R_BrightmapTexture("PIPEWAL1", fullbright_greenonly1);
+        R_BrightmapTexture("TEKLITE2", fullbright_greenonly1);
 
         // Green only 2
-        bmaptexture61 = R_TextureNumForName("SW2STARG");
-        bmaptexture62 = R_TextureNumForName("SW2BRN1");
+        R_BrightmapTexture("SW2STON2", fullbright_greenonly2);
+        R_BrightmapTexture("SW2STARG", fullbright_greenonly2);
+        R_BrightmapTexture("SW2BRN1", fullbright_greenonly2);
 
         // Orange and yellow
-        bmaptexture81 = R_TextureNumForName("TEKBRON2");
+        R_BrightmapTexture("TEKBRON2", fullbright_orangeyellow);
     }
 
     // -------------------------------------------------------
@@ -205,7 +217,7 @@ void R_InitBrightmappedTextures(void)
     if (gamemission == doom2)
     {
         // Green only 2
-        bmaptexture78 = R_TextureNumForName("SW2SKULL");
+        R_BrightmapTexture("SW2SKULL", fullbright_greenonly2);
     }
 
     // -------------------------------------------------------
@@ -214,32 +226,32 @@ void R_InitBrightmappedTextures(void)
     if (gamemission == pack_tnt)
     {
         // Red only
-        bmaptexture27 = R_TextureNumForName("LITERED2");
-        bmaptexture28 = R_TextureNumForName("PNK4EXIT");
+        R_BrightmapTexture("LITERED2", fullbright_redonly);
+        R_BrightmapTexture("PNK4EXIT", fullbright_redonly);
 
         // Not gray or brown
-        bmaptexture46 = R_TextureNumForName("BTNTMETL");
-        bmaptexture47 = R_TextureNumForName("BTNTSLVR");
-        bmaptexture48 = R_TextureNumForName("SLAD2");
-        bmaptexture49 = R_TextureNumForName("SLAD3");
-        bmaptexture50 = R_TextureNumForName("SLAD4");
-        bmaptexture51 = R_TextureNumForName("SLAD5");
-        bmaptexture52 = R_TextureNumForName("SLAD6");
-        bmaptexture53 = R_TextureNumForName("SLAD7");
-        bmaptexture54 = R_TextureNumForName("SLAD8");
-        bmaptexture55 = R_TextureNumForName("SLAD9");
-        bmaptexture56 = R_TextureNumForName("SLAD10");
-        bmaptexture57 = R_TextureNumForName("SLAD11");
-        bmaptexture59 = R_TextureNumForName("SLADRIP1");
-        bmaptexture60 = R_TextureNumForName("SLADRIP3");
+        R_BrightmapTexture("BTNTMETL", fullbright_notgrayorbrown);
+        R_BrightmapTexture("BTNTSLVR", fullbright_notgrayorbrown);
+        R_BrightmapTexture("SLAD2", fullbright_notgrayorbrown);
+        R_BrightmapTexture("SLAD3", fullbright_notgrayorbrown);
+        R_BrightmapTexture("SLAD4", fullbright_notgrayorbrown);
+        R_BrightmapTexture("SLAD5", fullbright_notgrayorbrown);
+        R_BrightmapTexture("SLAD6", fullbright_notgrayorbrown);
+        R_BrightmapTexture("SLAD7", fullbright_notgrayorbrown);
+        R_BrightmapTexture("SLAD8", fullbright_notgrayorbrown);
+        R_BrightmapTexture("SLAD9", fullbright_notgrayorbrown);
+        R_BrightmapTexture("SLAD10", fullbright_notgrayorbrown);
+        R_BrightmapTexture("SLAD11", fullbright_notgrayorbrown);
+        R_BrightmapTexture("SLADRIP1", fullbright_notgrayorbrown);
+        R_BrightmapTexture("SLADRIP3", fullbright_notgrayorbrown);
 
         // Green only 2
-        bmaptexture79 = R_TextureNumForName("M_TEC");
+        R_BrightmapTexture("M_TEC", fullbright_greenonly2);
 
         // Orange and yellow
-        bmaptexture82 = R_TextureNumForName("LITEYEL2");
-        bmaptexture83 = R_TextureNumForName("LITEYEL3");
-        bmaptexture84 = R_TextureNumForName("YELMETAL");
+        R_BrightmapTexture("LITEYEL2", fullbright_orangeyellow);
+        R_BrightmapTexture("LITEYEL3", fullbright_orangeyellow);
+        R_BrightmapTexture("YELMETAL", fullbright_orangeyellow);
     }
     // -------------------------------------------------------
     //  Plutonia only
@@ -247,59 +259,45 @@ void R_InitBrightmappedTextures(void)
     if (gamemission == pack_plut)
     {
         // Dimmed items (red color)
-        bmaptexture85 = R_TextureNumForName("SW2SKULL");
+        R_BrightmapTexture("SW2SKULL", fullbright_dimmeditems);
     }
 
     // -------------------------------------------------------
     //  All games
     // -------------------------------------------------------
     {
-        // In both games - Doom 1: red only, Doom 2: green only
-        bmaptexture24 = R_TextureNumForName("SW2STON2");
-
         // Red only
-        bmaptexture03 = R_TextureNumForName("SW1BRCOM");
-        bmaptexture04 = R_TextureNumForName("SW1DIRT");
-        bmaptexture05 = R_TextureNumForName("SW1STRTN");
-        bmaptexture07 = R_TextureNumForName("SW2SLAD");
-        bmaptexture13 = R_TextureNumForName("SW1COMM");
-        bmaptexture15 = R_TextureNumForName("SW1STON1");
-        bmaptexture21 = R_TextureNumForName("SW2COMP");
-        bmaptexture22 = R_TextureNumForName("SW1STONE");
-        bmaptexture39 = R_TextureNumForName("EXITSIGN");
+        R_BrightmapTexture("SW1BRCOM", fullbright_redonly);
+        R_BrightmapTexture("SW1DIRT", fullbright_redonly);
+        R_BrightmapTexture("SW1STRTN", fullbright_redonly);
+        R_BrightmapTexture("SW2SLAD", fullbright_redonly);
+        R_BrightmapTexture("SW1COMM", fullbright_redonly);
+        R_BrightmapTexture("SW1STON1", fullbright_redonly);
+        R_BrightmapTexture("SW2COMP", fullbright_redonly);
+        R_BrightmapTexture("SW1STONE", fullbright_redonly);
+        R_BrightmapTexture("EXITSIGN", fullbright_redonly);
 
         // Not gray
-        bmaptexture29 = R_TextureNumForName("COMPSTA2");
-        bmaptexture31 = R_TextureNumForName("SW2EXIT");
-        bmaptexture32 = R_TextureNumForName("SW2GRAY1");
-        bmaptexture33 = R_TextureNumForName("COMPSTA1");
-        bmaptexture36 = R_TextureNumForName("LITEBLU1");
-        bmaptexture37 = R_TextureNumForName("SW2GRAY");
+        R_BrightmapTexture("COMPSTA2", fullbright_notgray);
+        R_BrightmapTexture("SW2EXIT", fullbright_notgray);
+        R_BrightmapTexture("SW2GRAY1", fullbright_notgray);
+        R_BrightmapTexture("COMPSTA1", fullbright_notgray);
+        R_BrightmapTexture("LITEBLU1", fullbright_notgray);
+        R_BrightmapTexture("SW2GRAY", fullbright_notgray);
 
         // Green only 1
-        bmaptexture68 = R_TextureNumForName("SW2BRN2");
-        bmaptexture69 = R_TextureNumForName("SW2COMM");
-        bmaptexture72 = R_TextureNumForName("SW2STRTN");
+        R_BrightmapTexture("SW2BRN2", fullbright_greenonly1);
+        R_BrightmapTexture("SW2COMM", fullbright_greenonly1);
+        R_BrightmapTexture("SW2STRTN", fullbright_greenonly1);
 
         // Green only 2
-        bmaptexture63 = R_TextureNumForName("SW2BRCOM");
-        bmaptexture64 = R_TextureNumForName("SW2STON1");
-        bmaptexture65 = R_TextureNumForName("SW2STONE");
-        bmaptexture70 = R_TextureNumForName("SW2DIRT");
+        R_BrightmapTexture("SW2BRCOM", fullbright_greenonly2);
+        R_BrightmapTexture("SW2STON1", fullbright_greenonly2);
+        R_BrightmapTexture("SW2STONE", fullbright_greenonly2);
+        R_BrightmapTexture("SW2DIRT", fullbright_greenonly2);
 
         // Green only 3
-        bmaptexture77 = R_TextureNumForName("SW2BRNGN");
-        bmaptexture80 = R_TextureNumForName("SW2METAL");
-    }
-
-    // -------------------------------------------------------
-    //  Brightmap terminator
-    // -------------------------------------------------------
-    {
-        // We need to declare a "terminator" - standard game texture,
-        // presented in all Doom series and using standard light formula.
-        // Otherwise, non-defined textures will use latest brightmap.
-        bmap_terminator = R_TextureNumForName("BIGDOOR2");
+        R_BrightmapTexture("SW2BRNGN", fullbright_greenonly3);
+        R_BrightmapTexture("SW2METAL", fullbright_greenonly3);
     }
 }
-
@@ -19,38 +19,22 @@
 #define __R_BMAPS__
 
 #include "r_data.h"
+#include "r_main.h"
 
 
+// [JN] Light tables of one brightmap for one light level, indexed the
+// same way as scalelight[] and zlight[] rows.
+typedef lighttable_t*   brightmap_t[MAXLIGHTSCALE];
+typedef lighttable_t*   flatbrightmap_t[MAXLIGHTZ];
+
 // Prototypes
 void R_InitBrightmaps (void);
 void R_InitBrightmappedTextures (void);
 
-// Floors and ceilings:
-extern int bmapflatnum1, bmapflatnum2, bmapflatnum3, bmapflatnum4;
-
-// Walls:
-extern int bmaptexture01, bmaptexture02, bmaptexture03, bmaptexture04, bmaptexture05,
-bmaptexture06, bmaptexture07, bmaptexture08, bmaptexture09, bmaptexture10,
-bmaptexture11, bmaptexture12, bmaptexture13, bmaptexture14, bmaptexture15,
-bmaptexture16, bmaptexture17, bmaptexture18, bmaptexture19, bmaptexture20,
-bmaptexture21, bmaptexture22, bmaptexture23, bmaptexture24, bmaptexture25,
-bmaptexture26, bmaptexture27, bmaptexture28, bmaptexture29, bmaptexture30,
-bmaptexture31, bmaptexture32, bmaptexture33, bmaptexture34, bmaptexture35,
-bmaptexture36, bmaptexture37, bmaptexture38, bmaptexture39, bmaptexture40,
-bmaptexture41, bmaptexture42, bmaptexture43, bmaptexture44, bmaptexture45,
-bmaptexture46, bmaptexture47, bmaptexture48, bmaptexture49, bmaptexture50,
-bmaptexture51, bmaptexture52, bmaptexture53, bmaptexture54, bmaptexture55,
-bmaptexture56, bmaptexture57, bmaptexture58, bmaptexture59, bmaptexture60,
-bmaptexture61, bmaptexture62, bmaptexture63, bmaptexture64, bmaptexture65,
-bmaptexture66, bmaptexture67, bmaptexture68, bmaptexture69, bmaptexture70,
-bmaptexture71, bmaptexture72, bmaptexture73, bmaptexture74, bmaptexture75,
-bmaptexture76, bmaptexture77, bmaptexture78, bmaptexture79, bmaptexture80,
-bmaptexture81, bmaptexture82, bmaptexture83, bmaptexture84, bmaptexture85,
-bmaptexture86, bmaptexture87, bmaptexture88, bmaptexture89, bmaptexture90,
-bmaptexture91, bmaptexture92, bmaptexture93;
-
-// Terminator:
-extern int bmap_terminator;
+// [JN] Brightmap of every texture and flat, indexed by light level.
+// Textures and flats without a brightmap point to scalelight/zlight.
+extern brightmap_t**        texturebrightmap;
+extern flatbrightmap_t**    flatbrightmap;
 
 
 #endif // __R_BMAPS__
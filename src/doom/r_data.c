@@ -26,12 +26,14 @@
 #include "deh_main.h"
 #include "i_swap.h"
 #include "i_system.h"
+#include "i_thread.h"
 #include "z_zone.h"
 
 
 #include "w_wad.h"
 
 #include "doomdef.h"
+#include "m_cache.h"
 #include "m_misc.h"
 #include "r_local.h"
 #include "p_local.h"
@@ -41,6 +43,7 @@
 
 #include "r_data.h"
 #include "r_bmaps.h"
+#include "v_trans.h"
 #include "jn.h"
 
 
@@ -272,17 +275,19 @@ R_DrawColumnInCache
 
 
 //
-// R_GenerateComposite
+// R_DrawComposite
 // Using the texture definition,
 //  the composite texture is created from the patches,
 //  and each column is cached.
 //
 // Rewritten by Lee Killough for performance and to fix Medusa bug
+//
+// [JN] Draws into block from the patches in realpatches, locked by the
+// caller, and touches nothing else. Composites of different textures
+// can be drawn by several threads at once.
 
-static void R_GenerateComposite (int texnum)
+static void R_DrawComposite (int texnum, byte *block, patch_t **realpatches)
 {
-    byte *block = Z_Malloc(texturecompositesize[texnum], PU_STATIC, 
-                          (void **) &texturecomposite[texnum]);
     texture_t *texture = textures[texnum];
 
     // Composite the columns together.
@@ -299,7 +304,7 @@ static void R_GenerateComposite (int texnum)
 
     for (; --i >=0; patch++)
     {
-        patch_t *realpatch = W_CacheLumpNum(patch->patch, PU_CACHE);
+        patch_t *realpatch = *realpatches++;
         int x, x1 = patch->originx, x2 = x1 + SHORT(realpatch->width);
         const int *cofs = realpatch->columnofs - x1;
 
@@ -361,11 +366,64 @@ static void R_GenerateComposite (int texnum)
 
     free(source);         // free temporary column
     free(marks);          // free transparency marks
+}
+
+
+//
+// R_LockPatches
+// [JN] Caches the patches of a texture as PU_STATIC, so that the
+// pointers stay valid while other lumps are loaded or other threads
+// work on them. R_UnlockPatches makes them purgable again.
+//
+
+static void R_LockPatches (int texnum, patch_t **realpatches)
+{
+    const texture_t *texture = textures[texnum];
+    int i;
+
+    for (i = 0; i < texture->patchcount; i++)
+    {
+        realpatches[i] = W_CacheLumpNum(texture->patches[i].patch, PU_STATIC);
+    }
+}
+
+static void R_UnlockPatches (int texnum)
+{
+    const texture_t *texture = textures[texnum];
+    int i;
+
+    for (i = 0; i < texture->patchcount; i++)
+    {
+        W_ReleaseLumpNum(texture->patches[i].patch);
+    }
+}
+
+
+//
+// R_GenerateComposite
+// Builds the composite of one texture the first time it is drawn.
+//
+
+static void R_GenerateComposite (int texnum)
+{
+    patch_t **realpatches;
+    byte *block;
+
+    realpatches = malloc(textures[texnum]->patchcount * sizeof(*realpatches));
+    R_LockPatches(texnum, realpatches);
+
+    block = Z_Malloc(texturecompositesize[texnum], PU_STATIC, 
+                     (void **) &texturecomposite[texnum]);
+
+    R_DrawComposite(texnum, block, realpatches);
 
     // Now that the texture has been built in column cache,
     // it is purgable from zone memory.
 
     Z_ChangeTag(block, PU_CACHE);
+
+    R_UnlockPatches(texnum);
+    free(realpatches);
 }
 
 
@@ -375,7 +433,7 @@ static void R_GenerateComposite (int texnum)
 // Rewritten by Lee Killough for performance and to fix Medusa bug
 //
 
-static void R_GenerateLookup(int texnum)
+static void R_GenerateLookup(int texnum, patch_t **realpatches)
 {
     const texture_t *texture = textures[texnum];
 
@@ -399,7 +457,7 @@ static void R_GenerateLookup(int texnum)
     while (--i >= 0)
     {
         int pat = patch->patch;
-        const patch_t *realpatch = W_CacheLumpNum(pat, PU_CACHE);
+        const patch_t *realpatch = realpatches[texture->patchcount - 1 - i];
         int x, x1 = patch++->originx, x2 = x1 + SHORT(realpatch->width);
         const int *cofs = realpatch->columnofs - x1;
 
@@ -436,8 +494,7 @@ static void R_GenerateLookup(int texnum)
         
         for (i = texture->patchcount, patch = texture->patches; --i >= 0;)
         {
-            int pat = patch->patch;
-            const patch_t *realpatch = W_CacheLumpNum(pat, PU_CACHE);
+            const patch_t *realpatch = realpatches[texture->patchcount - 1 - i];
             int x, x1 = patch++->originx, x2 = x1 + SHORT(realpatch->width);
             const int *cofs = realpatch->columnofs - x1;
 
@@ -539,6 +596,98 @@ static void R_GenerateLookup(int texnum)
 }
 
 
+//
+// R_BuildTextures
+// [JN] Generates the lookups, or the composites, of a list of textures
+// on all render threads. Zone memory and the WAD cache are only used
+// by the calling thread: it locks the patches and allocates the
+// composites of a batch of textures, the threads build them, then it
+// lets go of the patches again.
+//
+
+#define TEXTUREBATCH 256
+
+typedef struct
+{
+    int texnum;
+    byte *block;            // composite, NULL when building lookups
+    patch_t **realpatches;
+} texturejob_t;
+
+static void R_TextureJob (void *data, int index)
+{
+    texturejob_t *job = (texturejob_t *) data + index;
+
+    if (job->block != NULL)
+    {
+        R_DrawComposite(job->texnum, job->block, job->realpatches);
+    }
+    else
+    {
+        R_GenerateLookup(job->texnum, job->realpatches);
+    }
+}
+
+static void R_BuildTextures (const int *texnums, int count, boolean composite)
+{
+    texturejob_t *jobs;
+    patch_t **realpatches;
+    int numpatches, numjobs;
+    int i, j, n;
+
+    jobs = malloc(TEXTUREBATCH * sizeof(*jobs));
+
+    for (i = 0; i < count; i += TEXTUREBATCH)
+    {
+        n = count - i < TEXTUREBATCH ? count - i : TEXTUREBATCH;
+
+        for (j = 0, numpatches = 0; j < n; j++)
+        {
+            numpatches += textures[texnums[i + j]]->patchcount;
+        }
+
+        realpatches = malloc((numpatches + 1) * sizeof(*realpatches));
+
+        for (j = 0, numpatches = 0, numjobs = 0; j < n; j++)
+        {
+            texturejob_t *job = &jobs[numjobs];
+
+            job->texnum = texnums[i + j];
+
+            if (composite && texturecomposite[job->texnum] != NULL)
+            {
+                continue;
+            }
+
+            job->realpatches = realpatches + numpatches;
+            R_LockPatches(job->texnum, job->realpatches);
+            numpatches += textures[job->texnum]->patchcount;
+
+            job->block = composite ?
+                Z_Malloc(texturecompositesize[job->texnum], PU_STATIC,
+                         (void **) &texturecomposite[job->texnum]) : NULL;
+            numjobs++;
+        }
+
+        I_RunParallel(R_TextureJob, jobs, numjobs);
+
+        for (j = 0; j < numjobs; j++)
+        {
+            if (jobs[j].block != NULL)
+            {
+                Z_ChangeTag(jobs[j].block, PU_CACHE);
+            }
+
+            R_UnlockPatches(jobs[j].texnum);
+        }
+
+        free(realpatches);
+    }
+
+    free(jobs);
+}
+
+
 //
 // R_GetColumn
 //
@@ -568,6 +717,57 @@ R_GetColumn
 }
 
 
+//
+// R_CacheColumn
+// [JN] Same as R_GetColumn, but a single-patched column's lump is
+// cached as PU_STATIC, so the pointer stays valid while other lumps
+// are loaded. Its number is returned in *lumpnum for releasing with
+// W_ReleaseLumpNum, or -1 if the column comes from the composite,
+// which is then locked until R_ReleaseComposite.
+//
+byte*
+R_CacheColumn
+( int		tex,
+  int		col,
+  int*		lumpnum )
+{
+    int		lump;
+    int		ofs;
+    int		ofs2;
+	
+    col &= texturewidthmask[tex];
+    lump = texturecolumnlump[tex][col];
+    ofs = texturecolumnofs[tex][col];
+    ofs2 = texturecolumnofs2[tex][col];
+
+    if (lump > 0)
+    {
+        *lumpnum = lump;
+        return (byte *)W_CacheLumpNum(lump,PU_STATIC)+ofs2;
+    }
+
+    *lumpnum = -1;
+
+    if (!texturecomposite[tex])
+	R_GenerateComposite (tex);
+
+    Z_ChangeTag (texturecomposite[tex], PU_STATIC);
+
+    return texturecomposite[tex] + ofs;
+}
+
+
+//
+// R_ReleaseComposite
+// [JN] Lets a composite locked by R_CacheColumn be purged again.
+//
+void R_ReleaseComposite (int tex)
+{
+    if (texturecomposite[tex])
+	Z_ChangeTag (texturecomposite[tex], PU_CACHE);
+}
+
+
 static void GenerateTextureHashTable(void)
 {
     texture_t **rover;
@@ -913,8 +1113,15 @@ void R_InitTextures (void)
     
     // Precalculate whatever possible.	
 
-    for (i=0 ; i<numtextures ; i++)
-	R_GenerateLookup (i);
+    {
+        int *texnums = malloc(numtextures * sizeof(*texnums));
+
+        for (i=0 ; i<numtextures ; i++)
+            texnums[i] = i;
+
+        R_BuildTextures(texnums, numtextures, false);
+        free(texnums);
+    }
     
     // Create translation table for global animation.
     texturetranslation = Z_Malloc ((numtextures+1)*sizeof(*texturetranslation), PU_STATIC, 0);
@@ -1002,8 +1209,26 @@ void R_InitTranMap()
     long pal[3][256], tot[256], pal_w1[3][256];
     long w1 = ((unsigned long) tran_filter_pct<<TSC)/100;
     long w2 = (1l<<TSC)-w1;
+    palcube_t *cube;
+    sha1_context_t context;
+    sha1_digest_t key;
     tranmap = Z_Malloc(256*256, PU_STATIC, 0);  // killough 4/11/98
 
+    // [JN] Use the map from the table cache if it was made from the
+    // same palette and filter percent.
+    M_CacheKey(&context, "tranmap", 1);
+    SHA1_Update(&context, playpal, 256*3);
+    SHA1_UpdateInt32(&context, tran_filter_pct);
+    SHA1_Final(key, &context);
+
+    if (M_CacheRead("tranmap", key, tranmap, 256*256))
+    {
+        W_ReleaseLumpName("PLAYPAL");
+        return;
+    }
+
+    cube = V_NewPaletteCube(playpal);
+
     // First, convert playpal into long int type, and transpose array,
     // for fast inner-loop calculations. Precompute tot array.
     {
@@ -1035,21 +1260,32 @@ void R_InitTranMap()
             long b1 = pal[2][i] * w2;
             for (j=0;j<256;j++,tp++)
             {
-                int color = 255;
+                int color, count;
                 long err;
                 long r = pal_w1[0][j] + r1;
                 long g = pal_w1[1][j] + g1;
                 long b = pal_w1[2][j] + b1;
                 long best = LONG_MAX;
-                do
+                // [JN] err grows with the distance to the blended colour,
+                // so only the candidates of its cell in the inverse colour
+                // cube have to be checked. Going down from the highest
+                // one keeps ties the same as a search of all 256 colours.
+                const byte *list = V_CubeCandidates(cube, r >> TSC,
+                                                    g >> TSC, b >> TSC,
+                                                    &count);
+                while (--count >= 0)
+                {
+                    color = list[count];
                     if ((err = tot[color] - pal[0][color]*r
                         - pal[1][color]*g - pal[2][color]*b) < best)
                         best = err, *tp = color;
-                    while (--color >= 0);
+                }
             }
         }
     }
 
+    V_FreePaletteCube(cube);
+    M_CacheWrite("tranmap", key, tranmap, 256*256);
     W_ReleaseLumpName("PLAYPAL");
 }
 
@@ -1250,6 +1486,27 @@ int	R_TextureNumForName (char* name)
 
 
 
+//
+// R_PrecacheLump
+// Queues a lump for R_PrecacheLevel, which loads them all in one go
+// with W_CacheLumps.
+//
+
+static lumpindex_t *precachelumps;
+static int numprecachelumps, maxprecachelumps;
+
+static void R_PrecacheLump (int lump)
+{
+    if (numprecachelumps == maxprecachelumps)
+    {
+        maxprecachelumps = maxprecachelumps ? maxprecachelumps * 2 : 512;
+        precachelumps = I_Realloc(precachelumps,
+                                  maxprecachelumps * sizeof(*precachelumps));
+    }
+
+    precachelumps[numprecachelumps++] = lump;
+}
+
 //
 // R_PrecacheLevel
 // Preloads all relevant graphics for the level.
@@ -1261,6 +1518,8 @@ void R_PrecacheLevel (void)
 {
     register int i;
     register byte *hitlist;
+    int *texnums;
+    int numtexnums = 0;
 
     if (demoplayback)
     return;
@@ -1270,6 +1529,8 @@ void R_PrecacheLevel (void)
         hitlist = malloc(numtextures > size ? numtextures : size);
     }
 
+    texnums = malloc(numtextures * sizeof(*texnums));
+
     // Precache flats.
 
     memset(hitlist, 0, numflats);
@@ -1279,7 +1540,7 @@ void R_PrecacheLevel (void)
 
     for (i = numflats; --i >= 0; )
         if (hitlist[i])
-            W_CacheLumpNum(firstflat + i, PU_CACHE);
+            R_PrecacheLump(firstflat + i);
 
     // Precache textures.
 
@@ -1306,7 +1567,9 @@ void R_PrecacheLevel (void)
             int j = texture->patchcount;
 
             while (--j >= 0)
-            W_CacheLumpNum(texture->patches[j].patch, PU_CACHE);
+            R_PrecacheLump(texture->patches[j].patch);
+
+            texnums[numtexnums++] = i;
         }
 
     // Precache sprites.
@@ -1330,12 +1593,21 @@ void R_PrecacheLevel (void)
                 int k = 7;
 
                 do
-                W_CacheLumpNum(firstspritelump + sflump[k], PU_CACHE);
+                R_PrecacheLump(firstspritelump + sflump[k]);
                 while (--k >= 0);
             }
         }
 
     free(hitlist);
+
+    // Read everything in file order.
+    W_CacheLumps(precachelumps, numprecachelumps, PU_CACHE);
+    numprecachelumps = 0;
+
+    // [JN] Composite the level's textures now, on all render threads,
+    // instead of one by one the first time each of them is seen.
+    R_BuildTextures(texnums, numtexnums, true);
+    free(texnums);
 }
 
 
@@ -39,6 +39,15 @@ R_GetColumn
   int		col,
   boolean	opaque );
 
+// [JN] Same, keeping the column's lump or composite locked.
+byte*
+R_CacheColumn
+( int		tex,
+  int		col,
+  int*		lumpnum );
+
+void R_ReleaseComposite (int tex);
+
 
 // I/O, setting up the stuff.
 void R_InitData (void);
@@ -338,6 +338,37 @@ typedef struct
 typedef byte	lighttable_t;	
 
 
+//
+// [JN] Input of a column or span drawer, filled by the caller
+//  and passed explicitly instead of global dc_*/ds_* variables.
+//
+typedef struct
+{
+    // Column drawers (R_DrawColumn and friends).
+    int			x;
+    int			yl;
+    int			yh;
+    fixed_t		iscale;
+    fixed_t		texturemid;
+    int			texheight;
+    byte*		translation;
+
+    // First pixel in a column (possibly virtual),
+    //  or start of a 64*64 tile image for spans.
+    byte*		source;
+    lighttable_t*	colormap;
+
+    // Span drawers (R_DrawSpan and friends).
+    int			y;
+    int			x1;
+    int			x2;
+    fixed_t		xfrac;
+    fixed_t		yfrac;
+    fixed_t		xstep;
+    fixed_t		ystep;
+} drawcontext_t;
+
+
 
 
 //
@@ -377,10 +408,6 @@ typedef struct drawseg_s
 // I.e. a sprite object that is partly visible.
 typedef struct vissprite_s
 {
-    // Doubly linked list.
-    struct vissprite_s*	prev;
-    struct vissprite_s*	next;
-    
     int			x1;
     int			x2;
 
@@ -468,6 +495,7 @@ typedef struct
   int			lightlevel;
   int			minx;
   int			maxx;
+  int			next; // [JN] index of next visplane in hash chain
   
   // leave pads for [minx-1]/[maxx+1]
   
@@ -24,6 +24,7 @@
 #include "doomdef.h"
 #include "deh_main.h"
 
+#include "i_simd.h"
 #include "i_system.h"
 #include "z_zone.h"
 #include "w_wad.h"
@@ -87,18 +88,6 @@ static byte *background_buffer = NULL;
 // Source is the top of the column to scale.
 //
 
-lighttable_t*   dc_colormap; 
-int             dc_x; 
-int             dc_yl; 
-int             dc_yh; 
-fixed_t         dc_iscale; 
-fixed_t         dc_texturemid;
-int             dc_texheight;
-
-
-// first pixel in a column (possibly virtual) 
-byte*   dc_source;		
-
 // just for profiling 
 int dccount;
 
@@ -114,25 +103,25 @@ extern int Crispy_Random(void);
 // Thus a special case loop for very fast rendering can
 //  be used. It has also been used with Wolfenstein 3D.
 // 
-void R_DrawColumn (void) 
+void R_DrawColumn (drawcontext_t *dc) 
 { 
     int                 count;
     register byte       *dest;     // killough
     register fixed_t    frac;      // killough
     fixed_t             fracstep;
 
-    count = dc_yh - dc_yl + 1;
+    count = dc->yh - dc->yl + 1;
 
     if (count <= 0)    // Zero length, column does not exceed a pixel.
     return;
 
 #ifdef RANGECHECK
-    if ((unsigned)dc_x >= screenwidth || dc_yl < 0 || dc_yh >= SCREENHEIGHT)
+    if ((unsigned)dc->x >= screenwidth || dc->yl < 0 || dc->yh >= SCREENHEIGHT)
     {
         I_Error (english_language ?
                  "R_DrawColumn: %i to %i at %i" :
                  "R_DrawColumn: %i к %i у %i",
-                 dc_yl, dc_yh, dc_x);
+                 dc->yl, dc->yh, dc->x);
     }
 #endif
 
@@ -140,12 +129,12 @@ void R_DrawColumn (void)
     // Use ylookup LUT to avoid multiply with ScreenWidth.
     // Use columnofs LUT for subwindows?
 
-    dest = ylookup[dc_yl] + columnofs[flipwidth[dc_x]];
+    dest = ylookup[dc->yl] + columnofs[flipwidth[dc->x]];
 
     // Determine scaling, which is the only mapping to be done.
 
-    fracstep = dc_iscale;
-    frac = dc_texturemid + (dc_yl-centery)*fracstep;
+    fracstep = dc->iscale;
+    frac = dc->texturemid + (dc->yl-centery)*fracstep;
 
     // Inner loop that does the actual texture mapping,
     //  e.g. a DDA-lile scaling.
@@ -154,11 +143,11 @@ void R_DrawColumn (void)
     // killough 2/1/98: more performance tuning
 
     {
-        register const byte *source = dc_source;
-        register const lighttable_t *colormap = dc_colormap;
-        register int heightmask = dc_texheight-1;
+        register const byte *source = dc->source;
+        register const lighttable_t *colormap = dc->colormap;
+        register int heightmask = dc->texheight-1;
 
-        if (dc_texheight & heightmask)   // not a power of 2 -- killough
+        if (dc->texheight & heightmask)   // not a power of 2 -- killough
         {
             heightmask++;
             heightmask <<= FRACBITS;
@@ -201,7 +190,7 @@ void R_DrawColumn (void)
 }
 
 
-void R_DrawColumnLow (void) 
+void R_DrawColumnLow (drawcontext_t *dc) 
 { 
     int         count; 
     byte*       dest; 
@@ -211,38 +200,40 @@ void R_DrawColumnLow (void)
     fixed_t     frac;
     fixed_t     fracstep;	 
     int         x;
-    int         heightmask = dc_texheight - 1;
+    int         heightmask = dc->texheight - 1;
+    const byte         *source = dc->source;
+    const lighttable_t *colormap = dc->colormap;
 
-    count = dc_yh - dc_yl; 
+    count = dc->yh - dc->yl; 
 
     // Zero length.
     if (count < 0) 
     return; 
 
 #ifdef RANGECHECK 
-    if ((unsigned)dc_x >= screenwidth || dc_yl < 0 || dc_yh >= SCREENHEIGHT)
+    if ((unsigned)dc->x >= screenwidth || dc->yl < 0 || dc->yh >= SCREENHEIGHT)
     {
         I_Error (english_language ?
                  "R_DrawColumn: %i to %i at %i" :
                  "R_DrawColumn: %i к %i у %i",
-                 dc_yl, dc_yh, dc_x);
+                 dc->yl, dc->yh, dc->x);
     }
     //	dccount++; 
 #endif 
 
     // Blocky mode, need to multiply by 2.
-    x = dc_x << 1;
+    x = dc->x << 1;
 
-    dest = ylookup[(dc_yl << hires)] + columnofs[flipwidth[x]];
-    dest2 = ylookup[(dc_yl << hires)] + columnofs[flipwidth[x+1]];
-    dest3 = ylookup[(dc_yl << hires) + 1] + columnofs[flipwidth[x]];
-    dest4 = ylookup[(dc_yl << hires) + 1] + columnofs[flipwidth[x+1]];
+    dest = ylookup[(dc->yl << hires)] + columnofs[flipwidth[x]];
+    dest2 = ylookup[(dc->yl << hires)] + columnofs[flipwidth[x+1]];
+    dest3 = ylookup[(dc->yl << hires) + 1] + columnofs[flipwidth[x]];
+    dest4 = ylookup[(dc->yl << hires) + 1] + columnofs[flipwidth[x+1]];
 
-    fracstep = dc_iscale; 
-    frac = dc_texturemid + (dc_yl-centery)*fracstep;
+    fracstep = dc->iscale; 
+    frac = dc->texturemid + (dc->yl-centery)*fracstep;
 
     // heightmask is the Tutti-Frutti fix -- killough
-    if (dc_texheight & heightmask) // not a power of 2 -- killough
+    if (dc->texheight & heightmask) // not a power of 2 -- killough
     {
         heightmask++;
         heightmask <<= FRACBITS;
@@ -255,14 +246,14 @@ void R_DrawColumnLow (void)
 
         do
         {
-            *dest2 = *dest = dc_colormap[dc_source[frac>>FRACBITS]];
+            *dest2 = *dest = colormap[source[frac>>FRACBITS]];
 
             dest += screenwidth << hires;
             dest2 += screenwidth << hires;
 
             if (hires)
             {
-                *dest4 = *dest3 = dc_colormap[dc_source[frac>>FRACBITS]];
+                *dest4 = *dest3 = colormap[source[frac>>FRACBITS]];
                 dest3 += screenwidth << hires;
                 dest4 += screenwidth << hires;
             }
@@ -276,13 +267,13 @@ void R_DrawColumnLow (void)
         do 
         {
             // Hack. Does not work corretly.
-            *dest2 = *dest = dc_colormap[dc_source[(frac>>FRACBITS)&heightmask]];
+            *dest2 = *dest = colormap[source[(frac>>FRACBITS)&heightmask]];
             dest += screenwidth << hires;
             dest2 += screenwidth << hires;
 
             if (hires)
             {
-                *dest4 = *dest3 = dc_colormap[dc_source[(frac>>FRACBITS)&heightmask]];
+                *dest4 = *dest3 = colormap[source[(frac>>FRACBITS)&heightmask]];
                 dest3 += screenwidth << hires;
                 dest4 += screenwidth << hires;
             }
@@ -367,7 +358,7 @@ void R_SetFuzzPosDraw (void)
 // [JN] Fuzz effect, original version (improved_fuzz = 0)
 // -----------------------------------------------------------------------------
 
-void R_DrawFuzzColumn (void) 
+void R_DrawFuzzColumn (drawcontext_t *dc) 
 { 
     int     count; 
     byte*   dest; 
@@ -380,36 +371,36 @@ void R_DrawFuzzColumn (void)
                                          fuzzoffset;
 
     // Adjust borders. Low... 
-    if (!dc_yl) 
-    dc_yl = 1;
+    if (!dc->yl) 
+    dc->yl = 1;
 
     // .. and high.
-    if (dc_yh == viewheight-1) 
+    if (dc->yh == viewheight-1) 
     {
-    dc_yh = viewheight - 2; 
+    dc->yh = viewheight - 2; 
     cutoff = true;
     }
 
-    count = dc_yh - dc_yl; 
+    count = dc->yh - dc->yl; 
 
     // Zero length.
     if (count < 0) 
     return; 
 
 #ifdef RANGECHECK 
-    if ((unsigned)dc_x >= screenwidth || dc_yl < 0 || dc_yh >= SCREENHEIGHT)
+    if ((unsigned)dc->x >= screenwidth || dc->yl < 0 || dc->yh >= SCREENHEIGHT)
     {
         I_Error (english_language ?
                  "R_DrawFuzzColumn: %i to %i at %i" :
-                 "R_DrawFuzzColumn: %i к %i у %i", dc_yl, dc_yh, dc_x);
+                 "R_DrawFuzzColumn: %i к %i у %i", dc->yl, dc->yh, dc->x);
     }
 #endif
 
-    dest = ylookup[dc_yl] + columnofs[flipwidth[dc_x]];
+    dest = ylookup[dc->yl] + columnofs[flipwidth[dc->x]];
 
     // Looks familiar.
-    fracstep = dc_iscale; 
-    frac = dc_texturemid + (dc_yl-centery)*fracstep; 
+    fracstep = dc->iscale; 
+    frac = dc->texturemid + (dc->yl-centery)*fracstep; 
 
     // Looks like an attempt at dithering,
     //  using the colormap #6 (of 0-31, a bit
@@ -452,7 +443,7 @@ void R_DrawFuzzColumn (void)
 
 
 // low detail mode version
-void R_DrawFuzzColumnLow (void) 
+void R_DrawFuzzColumnLow (drawcontext_t *dc) 
 { 
     int     count; 
     byte*   dest; 
@@ -469,43 +460,43 @@ void R_DrawFuzzColumnLow (void)
                                          fuzzoffset;
 
     // Adjust borders. Low... 
-    if (!dc_yl) 
-    dc_yl = 1;
+    if (!dc->yl) 
+    dc->yl = 1;
 
     // .. and high.
-    if (dc_yh == viewheight-1)
+    if (dc->yh == viewheight-1)
     {
-    dc_yh = viewheight - 2; 
+    dc->yh = viewheight - 2; 
     cutoff = true;
     }
 
-    count = dc_yh - dc_yl; 
+    count = dc->yh - dc->yl; 
 
     // Zero length.
     if (count < 0) 
     return; 
 
     // low detail mode, need to multiply by 2
-    x = dc_x << 1;
+    x = dc->x << 1;
 
 #ifdef RANGECHECK 
-    if ((unsigned)x >= screenwidth || dc_yl < 0 || dc_yh >= SCREENHEIGHT)
+    if ((unsigned)x >= screenwidth || dc->yl < 0 || dc->yh >= SCREENHEIGHT)
     {
         I_Error (english_language ?
                  "R_DrawFuzzColumnLow: %i to %i at %i" :
                  "R_DrawFuzzColumnLow: %i к %i у %i",
-                 dc_yl, dc_yh, dc_x);
+                 dc->yl, dc->yh, dc->x);
     }
 #endif
 
-    dest  = ylookup[(dc_yl << hires)] + columnofs[flipwidth[x]];
-    dest2 = ylookup[(dc_yl << hires)] + columnofs[flipwidth[x+1]];
-    dest3 = ylookup[(dc_yl << hires) + 1] + columnofs[flipwidth[x]];
-    dest4 = ylookup[(dc_yl << hires) + 1] + columnofs[flipwidth[x+1]];
+    dest  = ylookup[(dc->yl << hires)] + columnofs[flipwidth[x]];
+    dest2 = ylookup[(dc->yl << hires)] + columnofs[flipwidth[x+1]];
+    dest3 = ylookup[(dc->yl << hires) + 1] + columnofs[flipwidth[x]];
+    dest4 = ylookup[(dc->yl << hires) + 1] + columnofs[flipwidth[x+1]];
 
     // Looks familiar.
-    fracstep = dc_iscale; 
-    frac = dc_texturemid + (dc_yl-centery)*fracstep; 
+    fracstep = dc->iscale; 
+    frac = dc->texturemid + (dc->yl-centery)*fracstep; 
 
     // Looks like an attempt at dithering,
     //  using the colormap #6 (of 0-31, a bit
@@ -568,7 +559,7 @@ void R_DrawFuzzColumnLow (void)
 // [JN] Fuzz effect, original version + black and white (improved_fuzz = 1)
 // -----------------------------------------------------------------------------
 
-void R_DrawFuzzColumnBW (void) 
+void R_DrawFuzzColumnBW (drawcontext_t *dc) 
 { 
     int     count; 
     byte*   dest; 
@@ -581,32 +572,32 @@ void R_DrawFuzzColumnBW (void)
                        widescreen == 2 ? wfuzzoffset_16_10 :
                                          fuzzoffset;
 
-    if (!dc_yl) 
-    dc_yl = 1;
+    if (!dc->yl) 
+    dc->yl = 1;
 
-    if (dc_yh == viewheight-1) 
+    if (dc->yh == viewheight-1) 
     {
-        dc_yh = viewheight - 2; 
+        dc->yh = viewheight - 2; 
         cutoff = true;
     }
 
-    count = dc_yh - dc_yl; 
+    count = dc->yh - dc->yl; 
 
     if (count < 0) 
     return; 
 
 #ifdef RANGECHECK 
-    if ((unsigned)dc_x >= screenwidth || dc_yl < 0 || dc_yh >= SCREENHEIGHT)
+    if ((unsigned)dc->x >= screenwidth || dc->yl < 0 || dc->yh >= SCREENHEIGHT)
     {
         I_Error (english_language ?
                  "R_DrawFuzzColumnBW: %i to %i at %i" :
-                 "R_DrawFuzzColumnBW: %i к %i у %i", dc_yl, dc_yh, dc_x);
+                 "R_DrawFuzzColumnBW: %i к %i у %i", dc->yl, dc->yh, dc->x);
     }
 #endif
 
-    dest = ylookup[dc_yl] + columnofs[flipwidth[dc_x]];
-    fracstep = dc_iscale; 
-    frac = dc_texturemid + (dc_yl-centery)*fracstep; 
+    dest = ylookup[dc->yl] + columnofs[flipwidth[dc->x]];
+    fracstep = dc->iscale; 
+    frac = dc->texturemid + (dc->yl-centery)*fracstep; 
 
     do 
     {
@@ -637,7 +628,7 @@ void R_DrawFuzzColumnBW (void)
     }
 } 
 
-void R_DrawFuzzColumnLowBW (void) 
+void R_DrawFuzzColumnLowBW (drawcontext_t *dc) 
 { 
     int     count; 
     byte*   dest; 
@@ -654,38 +645,38 @@ void R_DrawFuzzColumnLowBW (void)
                        widescreen == 2 ? wfuzzoffset_16_10 :
                                          fuzzoffset;
 
-    if (!dc_yl) 
-    dc_yl = 1;
+    if (!dc->yl) 
+    dc->yl = 1;
 
-    if (dc_yh == viewheight-1)
+    if (dc->yh == viewheight-1)
     {
-        dc_yh = viewheight - 2; 
+        dc->yh = viewheight - 2; 
         cutoff = true;
     }
 
-    count = dc_yh - dc_yl; 
+    count = dc->yh - dc->yl; 
 
     if (count < 0) 
     return; 
 
-    x = dc_x << 1;
+    x = dc->x << 1;
 
 #ifdef RANGECHECK 
-    if ((unsigned)x >= screenwidth || dc_yl < 0 || dc_yh >= SCREENHEIGHT)
+    if ((unsigned)x >= screenwidth || dc->yl < 0 || dc->yh >= SCREENHEIGHT)
     {
         I_Error (english_language ?
                  "R_DrawFuzzColumnLowBW: %i to %i at %i" :
                  "R_DrawFuzzColumnLowBW: %i к %i у %i",
-                 dc_yl, dc_yh, dc_x);
+                 dc->yl, dc->yh, dc->x);
     }
 #endif
 
-    dest  = ylookup[(dc_yl << hires)] + columnofs[flipwidth[x]];
-    dest2 = ylookup[(dc_yl << hires)] + columnofs[flipwidth[x+1]];
-    dest3 = ylookup[(dc_yl << hires) + 1] + columnofs[flipwidth[x]];
-    dest4 = ylookup[(dc_yl << hires) + 1] + columnofs[flipwidth[x+1]];
-    fracstep = dc_iscale; 
-    frac = dc_texturemid + (dc_yl-centery)*fracstep; 
+    dest  = ylookup[(dc->yl << hires)] + columnofs[flipwidth[x]];
+    dest2 = ylookup[(dc->yl << hires)] + columnofs[flipwidth[x+1]];
+    dest3 = ylookup[(dc->yl << hires) + 1] + columnofs[flipwidth[x]];
+    dest4 = ylookup[(dc->yl << hires) + 1] + columnofs[flipwidth[x+1]];
+    fracstep = dc->iscale; 
+    frac = dc->texturemid + (dc->yl-centery)*fracstep; 
 
     do 
     {
@@ -738,7 +729,7 @@ void R_DrawFuzzColumnLowBW (void)
 // [JN] Fuzz effect, improved version (improved_fuzz = 2)
 // -----------------------------------------------------------------------------
 
-void R_DrawFuzzColumnImproved (void)
+void R_DrawFuzzColumnImproved (drawcontext_t *dc)
 { 
     int     count; 
     byte*   dest; 
@@ -750,32 +741,32 @@ void R_DrawFuzzColumnImproved (void)
                        widescreen == 2 ? wfuzzoffset_16_10 :
                                          fuzzoffset;
 
-    if (!dc_yl) 
-    dc_yl = 1;
+    if (!dc->yl) 
+    dc->yl = 1;
 
-    if (dc_yh == viewheight-1) 
+    if (dc->yh == viewheight-1) 
     {
-        dc_yh = viewheight - 2; 
+        dc->yh = viewheight - 2; 
         cutoff = true;
     }
 
-    count = dc_yh - dc_yl; 
+    count = dc->yh - dc->yl; 
 
     if (count < 0) 
     return; 
 
 #ifdef RANGECHECK 
-    if ((unsigned)dc_x >= screenwidth || dc_yl < 0 || dc_yh >= SCREENHEIGHT)
+    if ((unsigned)dc->x >= screenwidth || dc->yl < 0 || dc->yh >= SCREENHEIGHT)
     {
         I_Error (english_language ?
                  "R_DrawFuzzColumnImproved: %i to %i at %i" :
-                 "R_DrawFuzzColumnImproved: %i к %i у %i", dc_yl, dc_yh, dc_x);
+                 "R_DrawFuzzColumnImproved: %i к %i у %i", dc->yl, dc->yh, dc->x);
     }
 #endif
 
-    dest = ylookup[dc_yl] + columnofs[flipwidth[dc_x]];
-    fracstep = dc_iscale; 
-    frac = dc_texturemid + (dc_yl-centery)*fracstep; 
+    dest = ylookup[dc->yl] + columnofs[flipwidth[dc->x]];
+    fracstep = dc->iscale; 
+    frac = dc->texturemid + (dc->yl-centery)*fracstep; 
 
     do 
     {
@@ -808,7 +799,7 @@ void R_DrawFuzzColumnImproved (void)
     }
 } 
 
-void R_DrawFuzzColumnLowImproved (void) 
+void R_DrawFuzzColumnLowImproved (drawcontext_t *dc) 
 { 
     int     count; 
     byte*   dest; 
@@ -824,38 +815,38 @@ void R_DrawFuzzColumnLowImproved (void)
                        widescreen == 2 ? wfuzzoffset_16_10 :
                                          fuzzoffset;
 
-    if (!dc_yl) 
-    dc_yl = 1;
+    if (!dc->yl) 
+    dc->yl = 1;
 
-    if (dc_yh == viewheight-1)
+    if (dc->yh == viewheight-1)
     {
-        dc_yh = viewheight - 2; 
+        dc->yh = viewheight - 2; 
         cutoff = true;
     }
 
-    count = dc_yh - dc_yl; 
+    count = dc->yh - dc->yl; 
 
     if (count < 0) 
     return; 
 
-    x = dc_x << 1;
+    x = dc->x << 1;
 
 #ifdef RANGECHECK 
-    if ((unsigned)x >= screenwidth || dc_yl < 0 || dc_yh >= SCREENHEIGHT)
+    if ((unsigned)x >= screenwidth || dc->yl < 0 || dc->yh >= SCREENHEIGHT)
     {
         I_Error (english_language ?
                  "R_DrawFuzzColumnLowImproved: %i to %i at %i" :
                  "R_DrawFuzzColumnLowImproved: %i к %i у %i",
-                 dc_yl, dc_yh, dc_x);
+                 dc->yl, dc->yh, dc->x);
     }
 #endif
 
-    dest  = ylookup[(dc_yl << hires)] + columnofs[flipwidth[x]];
-    dest2 = ylookup[(dc_yl << hires)] + columnofs[flipwidth[x+1]];
-    dest3 = ylookup[(dc_yl << hires) + 1] + columnofs[flipwidth[x]];
-    dest4 = ylookup[(dc_yl << hires) + 1] + columnofs[flipwidth[x+1]];
-    fracstep = dc_iscale; 
-    frac = dc_texturemid + (dc_yl-centery)*fracstep; 
+    dest  = ylookup[(dc->yl << hires)] + columnofs[flipwidth[x]];
+    dest2 = ylookup[(dc->yl << hires)] + columnofs[flipwidth[x+1]];
+    dest3 = ylookup[(dc->yl << hires) + 1] + columnofs[flipwidth[x]];
+    dest4 = ylookup[(dc->yl << hires) + 1] + columnofs[flipwidth[x+1]];
+    fracstep = dc->iscale; 
+    frac = dc->texturemid + (dc->yl-centery)*fracstep; 
 
     do 
     {
@@ -910,7 +901,7 @@ void R_DrawFuzzColumnLowImproved (void)
 // [JN] Fuzz effect, improved version + black and white (improved_fuzz = 3)
 // -----------------------------------------------------------------------------
 
-void R_DrawFuzzColumnImprovedBW (void)
+void R_DrawFuzzColumnImprovedBW (drawcontext_t *dc)
 { 
     int     count; 
     byte*   dest; 
@@ -923,32 +914,32 @@ void R_DrawFuzzColumnImprovedBW (void)
                        widescreen == 2 ? wfuzzoffset_16_10 :
                                          fuzzoffset;
 
-    if (!dc_yl) 
-    dc_yl = 1;
+    if (!dc->yl) 
+    dc->yl = 1;
 
-    if (dc_yh == viewheight-1) 
+    if (dc->yh == viewheight-1) 
     {
-        dc_yh = viewheight - 2; 
+        dc->yh = viewheight - 2; 
         cutoff = true;
     }
 
-    count = dc_yh - dc_yl; 
+    count = dc->yh - dc->yl; 
 
     if (count < 0) 
     return; 
 
 #ifdef RANGECHECK 
-    if ((unsigned)dc_x >= screenwidth || dc_yl < 0 || dc_yh >= SCREENHEIGHT)
+    if ((unsigned)dc->x >= screenwidth || dc->yl < 0 || dc->yh >= SCREENHEIGHT)
     {
         I_Error (english_language ?
                  "R_DrawFuzzColumnImprovedBW: %i to %i at %i" :
-                 "R_DrawFuzzColumnImprovedBW: %i к %i у %i", dc_yl, dc_yh, dc_x);
+                 "R_DrawFuzzColumnImprovedBW: %i к %i у %i", dc->yl, dc->yh, dc->x);
     }
 #endif
 
-    dest = ylookup[dc_yl] + columnofs[flipwidth[dc_x]];
-    fracstep = dc_iscale; 
-    frac = dc_texturemid + (dc_yl-centery)*fracstep; 
+    dest = ylookup[dc->yl] + columnofs[flipwidth[dc->x]];
+    fracstep = dc->iscale; 
+    frac = dc->texturemid + (dc->yl-centery)*fracstep; 
 
     do 
     {
@@ -981,7 +972,7 @@ void R_DrawFuzzColumnImprovedBW (void)
     }
 } 
 
-void R_DrawFuzzColumnLowImprovedBW (void) 
+void R_DrawFuzzColumnLowImprovedBW (drawcontext_t *dc) 
 { 
     int     count; 
     byte*   dest; 
@@ -998,38 +989,38 @@ void R_DrawFuzzColumnLowImprovedBW (void)
                        widescreen == 2 ? wfuzzoffset_16_10 :
                                          fuzzoffset;
 
-    if (!dc_yl) 
-    dc_yl = 1;
+    if (!dc->yl) 
+    dc->yl = 1;
 
-    if (dc_yh == viewheight-1)
+    if (dc->yh == viewheight-1)
     {
-        dc_yh = viewheight - 2; 
+        dc->yh = viewheight - 2; 
         cutoff = true;
     }
 
-    count = dc_yh - dc_yl; 
+    count = dc->yh - dc->yl; 
 
     if (count < 0) 
     return; 
 
-    x = dc_x << 1;
+    x = dc->x << 1;
 
 #ifdef RANGECHECK 
-    if ((unsigned)x >= screenwidth || dc_yl < 0 || dc_yh >= SCREENHEIGHT)
+    if ((unsigned)x >= screenwidth || dc->yl < 0 || dc->yh >= SCREENHEIGHT)
     {
         I_Error (english_language ?
                  "R_DrawFuzzColumnLowImprovedBW: %i to %i at %i" :
                  "R_DrawFuzzColumnLowImprovedBW: %i к %i у %i",
-                 dc_yl, dc_yh, dc_x);
+                 dc->yl, dc->yh, dc->x);
     }
 #endif
 
-    dest  = ylookup[(dc_yl << hires)] + columnofs[flipwidth[x]];
-    dest2 = ylookup[(dc_yl << hires)] + columnofs[flipwidth[x+1]];
-    dest3 = ylookup[(dc_yl << hires) + 1] + columnofs[flipwidth[x]];
-    dest4 = ylookup[(dc_yl << hires) + 1] + columnofs[flipwidth[x+1]];
-    fracstep = dc_iscale; 
-    frac = dc_texturemid + (dc_yl-centery)*fracstep; 
+    dest  = ylookup[(dc->yl << hires)] + columnofs[flipwidth[x]];
+    dest2 = ylookup[(dc->yl << hires)] + columnofs[flipwidth[x+1]];
+    dest3 = ylookup[(dc->yl << hires) + 1] + columnofs[flipwidth[x]];
+    dest4 = ylookup[(dc->yl << hires) + 1] + columnofs[flipwidth[x+1]];
+    fracstep = dc->iscale; 
+    frac = dc->texturemid + (dc->yl-centery)*fracstep; 
 
     do 
     {
@@ -1090,35 +1081,34 @@ void R_DrawFuzzColumnLowImprovedBW (void)
 //  of the BaronOfHell, the HellKnight, uses
 //  identical sprites, kinda brightened up.
 //
-byte*   dc_translation;
 byte*   translationtables;
 
-void R_DrawTranslatedColumn (void) 
+void R_DrawTranslatedColumn (drawcontext_t *dc) 
 { 
     int         count; 
     byte*       dest; 
     fixed_t     frac;
     fixed_t     fracstep;	 
 
-    count = dc_yh - dc_yl; 
+    count = dc->yh - dc->yl; 
     if (count < 0) 
     return; 
 
 #ifdef RANGECHECK 
-    if ((unsigned)dc_x >= screenwidth || dc_yl < 0 || dc_yh >= SCREENHEIGHT)
+    if ((unsigned)dc->x >= screenwidth || dc->yl < 0 || dc->yh >= SCREENHEIGHT)
     {
         I_Error (english_language ?
                  "R_DrawColumn: %i to %i at %i" :
                  "R_DrawColumn: %i к %i у %i",
-                 dc_yl, dc_yh, dc_x);
+                 dc->yl, dc->yh, dc->x);
     }    
 #endif 
 
-    dest = ylookup[dc_yl] + columnofs[flipwidth[dc_x]];
+    dest = ylookup[dc->yl] + columnofs[flipwidth[dc->x]];
 
     // Looks familiar.
-    fracstep = dc_iscale; 
-    frac = dc_texturemid + (dc_yl-centery)*fracstep; 
+    fracstep = dc->iscale; 
+    frac = dc->texturemid + (dc->yl-centery)*fracstep; 
 
     // Here we do an additional index re-mapping.
     do 
@@ -1128,7 +1118,7 @@ void R_DrawTranslatedColumn (void)
         //  used with PLAY sprites.
         // Thus the "green" ramp of the player 0 sprite
         //  is mapped to gray, red, black/indigo. 
-        *dest = dc_colormap[dc_translation[dc_source[frac>>FRACBITS]]];
+        *dest = dc->colormap[dc->translation[dc->source[frac>>FRACBITS]]];
         dest += screenwidth;
 	
         frac += fracstep; 
@@ -1136,7 +1126,7 @@ void R_DrawTranslatedColumn (void)
 } 
 
 
-void R_DrawTranslatedColumnLow (void) 
+void R_DrawTranslatedColumnLow (drawcontext_t *dc) 
 { 
     int     count; 
     byte*   dest; 
@@ -1147,31 +1137,31 @@ void R_DrawTranslatedColumnLow (void)
     fixed_t fracstep;	 
     int     x;
 
-    count = dc_yh - dc_yl; 
+    count = dc->yh - dc->yl; 
     if (count < 0) 
     return; 
 
     // low detail, need to scale by 2
-    x = dc_x << 1;
+    x = dc->x << 1;
 
 #ifdef RANGECHECK 
-    if ((unsigned)x >= screenwidth || dc_yl < 0 || dc_yh >= SCREENHEIGHT)
+    if ((unsigned)x >= screenwidth || dc->yl < 0 || dc->yh >= SCREENHEIGHT)
     {
         I_Error (english_language ?
                  "R_DrawColumn: %i to %i at %i" :
                  "R_DrawColumn: %i к %i у %i",
-                 dc_yl, dc_yh, x);
+                 dc->yl, dc->yh, x);
     }
 #endif 
 
-    dest  = ylookup[(dc_yl << hires)] + columnofs[flipwidth[x]];
-    dest2 = ylookup[(dc_yl << hires)] + columnofs[flipwidth[x+1]];
-    dest3 = ylookup[(dc_yl << hires) + 1] + columnofs[flipwidth[x]];
-    dest4 = ylookup[(dc_yl << hires) + 1] + columnofs[flipwidth[x+1]];
+    dest  = ylookup[(dc->yl << hires)] + columnofs[flipwidth[x]];
+    dest2 = ylookup[(dc->yl << hires)] + columnofs[flipwidth[x+1]];
+    dest3 = ylookup[(dc->yl << hires) + 1] + columnofs[flipwidth[x]];
+    dest4 = ylookup[(dc->yl << hires) + 1] + columnofs[flipwidth[x+1]];
 
     // Looks familiar.
-    fracstep = dc_iscale; 
-    frac = dc_texturemid + (dc_yl-centery)*fracstep; 
+    fracstep = dc->iscale; 
+    frac = dc->texturemid + (dc->yl-centery)*fracstep; 
 
     // Here we do an additional index re-mapping.
     do 
@@ -1181,14 +1171,14 @@ void R_DrawTranslatedColumnLow (void)
         //  used with PLAY sprites.
         // Thus the "green" ramp of the player 0 sprite
         //  is mapped to gray, red, black/indigo. 
-        *dest = dc_colormap[dc_translation[dc_source[frac>>FRACBITS]]];
-        *dest2 = dc_colormap[dc_translation[dc_source[frac>>FRACBITS]]];
+        *dest = dc->colormap[dc->translation[dc->source[frac>>FRACBITS]]];
+        *dest2 = dc->colormap[dc->translation[dc->source[frac>>FRACBITS]]];
         dest += screenwidth << hires;
         dest2 += screenwidth << hires;
         if (hires)
         {
-            *dest3 = dc_colormap[dc_translation[dc_source[frac>>FRACBITS]]];
-            *dest4 = dc_colormap[dc_translation[dc_source[frac>>FRACBITS]]];
+            *dest3 = dc->colormap[dc->translation[dc->source[frac>>FRACBITS]]];
+            *dest4 = dc->colormap[dc->translation[dc->source[frac>>FRACBITS]]];
             dest3 += screenwidth << hires;
             dest4 += screenwidth << hires;
         }
@@ -1198,35 +1188,35 @@ void R_DrawTranslatedColumnLow (void)
 }
 
 
-void R_DrawTLColumn (void)
+void R_DrawTLColumn (drawcontext_t *dc)
 {
     int count;
     byte*   dest;
     fixed_t frac;
     fixed_t fracstep;
 
-    count = dc_yh - dc_yl;
+    count = dc->yh - dc->yl;
     if (count < 0)
     return;
 
 #ifdef RANGECHECK
-    if ((unsigned)dc_x >= screenwidth || dc_yl < 0 || dc_yh >= SCREENHEIGHT)
+    if ((unsigned)dc->x >= screenwidth || dc->yl < 0 || dc->yh >= SCREENHEIGHT)
     {
         I_Error (english_language ?
                  "R_DrawColumn: %i to %i at %i" :
                  "R_DrawColumn: %i к %i у %i",
-                 dc_yl, dc_yh, dc_x);
+                 dc->yl, dc->yh, dc->x);
     }
 #endif
 
-    dest = ylookup[dc_yl] + columnofs[flipwidth[dc_x]];
+    dest = ylookup[dc->yl] + columnofs[flipwidth[dc->x]];
 
-    fracstep = dc_iscale;
-    frac = dc_texturemid + (dc_yl-centery)*fracstep;
+    fracstep = dc->iscale;
+    frac = dc->texturemid + (dc->yl-centery)*fracstep;
 
     do
     {
-        *dest = tranmap[(*dest<<8)+dc_colormap[dc_source[frac>>FRACBITS]]];
+        *dest = tranmap[(*dest<<8)+dc->colormap[dc->source[frac>>FRACBITS]]];
         dest += screenwidth;
 
         frac += fracstep;
@@ -1235,7 +1225,7 @@ void R_DrawTLColumn (void)
 
 
 // [crispy] draw translucent column, low-resolution version
-void R_DrawTLColumnLow (void)
+void R_DrawTLColumnLow (drawcontext_t *dc)
 {
     int count;
     byte*   dest;
@@ -1246,41 +1236,41 @@ void R_DrawTLColumnLow (void)
     fixed_t fracstep;
     int     x;
 
-    count = dc_yh - dc_yl;
+    count = dc->yh - dc->yl;
     if (count < 0)
     return;
 
-    x = dc_x << 1;
+    x = dc->x << 1;
 
 #ifdef RANGECHECK
-    if ((unsigned)x >= screenwidth || dc_yl < 0 || dc_yh >= SCREENHEIGHT)
+    if ((unsigned)x >= screenwidth || dc->yl < 0 || dc->yh >= SCREENHEIGHT)
     {
         I_Error (english_language ?
                  "R_DrawColumn: %i to %i at %i" :
                  "R_DrawColumn: %i к %i у %i",
-                 dc_yl, dc_yh, x);
+                 dc->yl, dc->yh, x);
     }
 #endif
 
-    dest  = ylookup[(dc_yl << hires)] + columnofs[flipwidth[x]];
-    dest2 = ylookup[(dc_yl << hires)] + columnofs[flipwidth[x+1]];
-    dest3 = ylookup[(dc_yl << hires) + 1] + columnofs[flipwidth[x]];
-    dest4 = ylookup[(dc_yl << hires) + 1] + columnofs[flipwidth[x+1]];
+    dest  = ylookup[(dc->yl << hires)] + columnofs[flipwidth[x]];
+    dest2 = ylookup[(dc->yl << hires)] + columnofs[flipwidth[x+1]];
+    dest3 = ylookup[(dc->yl << hires) + 1] + columnofs[flipwidth[x]];
+    dest4 = ylookup[(dc->yl << hires) + 1] + columnofs[flipwidth[x+1]];
 
-    fracstep = dc_iscale;
-    frac = dc_texturemid + (dc_yl-centery)*fracstep;
+    fracstep = dc->iscale;
+    frac = dc->texturemid + (dc->yl-centery)*fracstep;
 
     do
     {
-        *dest = tranmap[(*dest<<8)+dc_colormap[dc_source[frac>>FRACBITS]]];
-        *dest2 = tranmap[(*dest2<<8)+dc_colormap[dc_source[frac>>FRACBITS]]];
+        *dest = tranmap[(*dest<<8)+dc->colormap[dc->source[frac>>FRACBITS]]];
+        *dest2 = tranmap[(*dest2<<8)+dc->colormap[dc->source[frac>>FRACBITS]]];
         dest += screenwidth << hires;
         dest2 += screenwidth << hires;
 
         if (hires)
         {
-            *dest3 = tranmap[(*dest3<<8)+dc_colormap[dc_source[frac>>FRACBITS]]];
-            *dest4 = tranmap[(*dest4<<8)+dc_colormap[dc_source[frac>>FRACBITS]]];
+            *dest3 = tranmap[(*dest3<<8)+dc->colormap[dc->source[frac>>FRACBITS]]];
+            *dest4 = tranmap[(*dest4<<8)+dc->colormap[dc->source[frac>>FRACBITS]]];
             dest3 += screenwidth << hires;
             dest4 += screenwidth << hires;
         }
@@ -1338,71 +1328,76 @@ void R_InitTranslationTables (void)
 // In consequence, flats are not stored by column (like walls),
 //  and the inner loop has to step in texture space u and v.
 //
-int	    ds_y; 
-int	    ds_x1; 
-int	    ds_x2;
-
-lighttable_t*   ds_colormap; 
-
-fixed_t     ds_xfrac; 
-fixed_t     ds_yfrac; 
-fixed_t     ds_xstep; 
-fixed_t     ds_ystep;
-
-// start of a 64*64 tile image 
-byte*   ds_source;	
-
 // just for profiling
 int dscount;
 
 
 //
 // Draws the actual span.
-void R_DrawSpan (void) 
+void R_DrawSpan (drawcontext_t *ds) 
 { 
     // unsigned int position, step;
     byte    *dest;
     int     count;
     int     spot;
     unsigned int xtemp, ytemp;
+    // [JN] Keep span state in locals, byte stores to the screen
+    // could alias the context and force reloads on every pixel.
+    int                 x = ds->x1;
+    fixed_t             xfrac = ds->xfrac;
+    fixed_t             yfrac = ds->yfrac;
+    const fixed_t       xstep = ds->xstep;
+    const fixed_t       ystep = ds->ystep;
+    const byte         *source = ds->source;
+    const lighttable_t *colormap = ds->colormap;
+    byte               *row = ylookup[ds->y];
 
 #ifdef RANGECHECK
-    if (ds_x2 < ds_x1 || ds_x1<0 || ds_x2>=screenwidth || (unsigned)ds_y>SCREENHEIGHT)
+    if (ds->x2 < ds->x1 || ds->x1<0 || ds->x2>=screenwidth || (unsigned)ds->y>SCREENHEIGHT)
     {
         I_Error(english_language ?
                 "R_DrawSpan: %i to %i at %i" :
                 "R_DrawSpan: %i к %i у %i",
-                ds_x1,ds_x2,ds_y);
+                ds->x1,ds->x2,ds->y);
     }
     //	dscount++;
 #endif
 
+    // [JN] Unflipped spans cover consecutive screen pixels,
+    // so they can go through the vectorized kernel.
+    if (!flip_levels)
+    {
+        I_DrawSpanRow(row + columnofs[x], source, colormap,
+                      xfrac, yfrac, xstep, ystep, ds->x2 - ds->x1 + 1);
+        return;
+    }
+
     // Pack position and step variables into a single 32-bit integer,
     // with x in the top 16 bits and y in the bottom 16 bits.  For
     // each 16-bit part, the top 6 bits are the integer part and the
     // bottom 10 bits are the fractional part of the pixel position.
-    // dest = ylookup[ds_y] + columnofs[ds_x1];
+    // dest = ylookup[ds->y] + columnofs[ds->x1];
 
     // We do not check for zero spans here?
-    count = ds_x2 - ds_x1;
+    count = ds->x2 - ds->x1;
 
     do
     {
         // Calculate current texture index in u,v.
         // [crispy] fix flats getting more distorted the closer they are to the right
-        ytemp = (ds_yfrac >> 10) & 0x0fc0;
-        xtemp = (ds_xfrac >> 16) & 0x3f;
+        ytemp = (yfrac >> 10) & 0x0fc0;
+        xtemp = (xfrac >> 16) & 0x3f;
         spot = xtemp | ytemp;
 
         // Lookup pixel from flat texture tile,
         //  re-index using light/colormap.
-        //*dest++ = ds_colormap[ds_source[spot]];
-        dest = ylookup[ds_y] + columnofs[flipwidth[ds_x1++]];
-        *dest = ds_colormap[ds_source[spot]];
+        //*dest++ = ds->colormap[ds->source[spot]];
+        dest = row + columnofs[flipwidth[x++]];
+        *dest = colormap[source[spot]];
 
         // position += step;
-        ds_xfrac += ds_xstep;
-        ds_yfrac += ds_ystep;
+        xfrac += xstep;
+        yfrac += ystep;
     } while (count--);
 }
 
@@ -1410,54 +1405,63 @@ void R_DrawSpan (void)
 //
 // Again..
 //
-void R_DrawSpanLow (void)
+void R_DrawSpanLow (drawcontext_t *ds)
 {
     unsigned int xtemp, ytemp;
     byte    *dest, *dest2;
     int     count;
     int     spot;
+    // [JN] Keep span state in locals, see above.
+    int                 x;
+    fixed_t             xfrac = ds->xfrac;
+    fixed_t             yfrac = ds->yfrac;
+    const fixed_t       xstep = ds->xstep;
+    const fixed_t       ystep = ds->ystep;
+    const byte         *source = ds->source;
+    const lighttable_t *colormap = ds->colormap;
+    byte               *row = ylookup[(ds->y << hires)];
+    byte               *row2 = ylookup[(ds->y << hires) + 1];
 
 #ifdef RANGECHECK
-    if (ds_x2 < ds_x1 || ds_x1<0 || ds_x2>=screenwidth || (unsigned)ds_y>SCREENHEIGHT)
+    if (ds->x2 < ds->x1 || ds->x1<0 || ds->x2>=screenwidth || (unsigned)ds->y>SCREENHEIGHT)
     {
         I_Error(english_language ?
                 "R_DrawSpan: %i to %i at %i" :
                 "R_DrawSpan: %i к %i у %i",
-                ds_x1,ds_x2,ds_y);
+                ds->x1,ds->x2,ds->y);
     }
 #endif
 
-    count = (ds_x2 - ds_x1);
+    count = (ds->x2 - ds->x1);
 
     // Blocky mode, need to multiply by 2.
-    ds_x1 <<= 1;
-    ds_x2 <<= 1;
+    x = ds->x1 << 1;
 
-    // dest = ylookup[(ds_y << hires)] + columnofs[ds_x1];
-    // dest2 = ylookup[(ds_y << hires) + 1] + columnofs[ds_x1];
+    // dest = ylookup[(ds->y << hires)] + columnofs[ds->x1];
+    // dest2 = ylookup[(ds->y << hires) + 1] + columnofs[ds->x1];
 
     do
     {
         // Calculate current texture index in u,v.
         // [crispy] fix flats getting more distorted the closer they are to the right
-        ytemp = (ds_yfrac >> 10) & 0x0fc0;
-        xtemp = (ds_xfrac >> 16) & 0x3f;
+        ytemp = (yfrac >> 10) & 0x0fc0;
+        xtemp = (xfrac >> 16) & 0x3f;
         spot = xtemp | ytemp;
 
         // Lowres/blocky mode does it twice,
         //  while scale is adjusted appropriately.
-        dest = ylookup[(ds_y << hires)] + columnofs[flipwidth[ds_x1]];
-        *dest = ds_colormap[ds_source[spot]];
-        dest2 = ylookup[(ds_y << hires) + 1] + columnofs[flipwidth[ds_x1++]];
-        *dest2 = ds_colormap[ds_source[spot]];
-        dest = ylookup[(ds_y << hires)] + columnofs[flipwidth[ds_x1]];
-        *dest = ds_colormap[ds_source[spot]];
-        dest2 = ylookup[(ds_y << hires) + 1] + columnofs[flipwidth[ds_x1++]];
-        *dest2 = ds_colormap[ds_source[spot]];
+        dest = row + columnofs[flipwidth[x]];
+        *dest = colormap[source[spot]];
+        dest2 = row2 + columnofs[flipwidth[x++]];
+        *dest2 = colormap[source[spot]];
+        dest = row + columnofs[flipwidth[x]];
+        *dest = colormap[source[spot]];
+        dest2 = row2 + columnofs[flipwidth[x++]];
+        *dest2 = colormap[source[spot]];
 
     // position += step;
-    ds_xfrac += ds_xstep;
-    ds_yfrac += ds_ystep;
+    xfrac += xstep;
+    yfrac += ystep;
 
     } while (count--);
 }
@@ -1634,6 +1638,10 @@ void R_VideoErase (unsigned ofs, int count)
     if (background_buffer != NULL)
     {
         memcpy(I_VideoBuffer + ofs, background_buffer + ofs, count * sizeof(*I_VideoBuffer));
+
+        // [JN] Mark the rows the copy has touched.
+        V_MarkScreen(0, ofs / screenwidth, screenwidth,
+                     (ofs + count - 1) / screenwidth - ofs / screenwidth + 1);
     }
 }
 
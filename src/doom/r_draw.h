@@ -24,34 +24,21 @@
 
 
 
-
-extern lighttable_t*	dc_colormap;
-extern int		dc_x;
-extern int		dc_yl;
-extern int		dc_yh;
-extern fixed_t		dc_iscale;
-extern fixed_t		dc_texturemid;
-extern int      dc_texheight;
-
-// first pixel in a column
-extern byte*		dc_source;		
-
-
 // The span blitting interface.
 // Hook in assembler or system specific BLT
 //  here.
-void 	R_DrawColumn (void);
-void 	R_DrawColumnLow (void);
+void 	R_DrawColumn (drawcontext_t *dc);
+void 	R_DrawColumnLow (drawcontext_t *dc);
 
 // The Spectre/Invisibility effect.
-void 	R_DrawFuzzColumn (void);
-void 	R_DrawFuzzColumnBW (void);
-void 	R_DrawFuzzColumnImproved (void);
-void 	R_DrawFuzzColumnImprovedBW (void);
-void 	R_DrawFuzzColumnLow (void);
-void 	R_DrawFuzzColumnLowBW (void);
-void 	R_DrawFuzzColumnLowImproved (void);
-void 	R_DrawFuzzColumnLowImprovedBW (void);
+void 	R_DrawFuzzColumn (drawcontext_t *dc);
+void 	R_DrawFuzzColumnBW (drawcontext_t *dc);
+void 	R_DrawFuzzColumnImproved (drawcontext_t *dc);
+void 	R_DrawFuzzColumnImprovedBW (drawcontext_t *dc);
+void 	R_DrawFuzzColumnLow (drawcontext_t *dc);
+void 	R_DrawFuzzColumnLowBW (drawcontext_t *dc);
+void 	R_DrawFuzzColumnLowImproved (drawcontext_t *dc);
+void 	R_DrawFuzzColumnLowImprovedBW (drawcontext_t *dc);
 
 // [crispy] draw fuzz effect independent of rendering frame rate
 void 	R_SetFuzzPosTic (void);
@@ -60,40 +47,25 @@ void 	R_SetFuzzPosDraw (void);
 // Draw with color translation tables,
 //  for player sprite rendering,
 //  Green/Red/Blue/Indigo shirts.
-void	R_DrawTranslatedColumn (void);
-void	R_DrawTranslatedColumnLow (void);
-void    R_DrawTLColumn (void);
-void    R_DrawTLColumnLow (void);
+void	R_DrawTranslatedColumn (drawcontext_t *dc);
+void	R_DrawTranslatedColumnLow (drawcontext_t *dc);
+void    R_DrawTLColumn (drawcontext_t *dc);
+void    R_DrawTLColumnLow (drawcontext_t *dc);
 
 void
 R_VideoErase
 ( unsigned	ofs,
   int		count );
 
-extern int		ds_y;
-extern int		ds_x1;
-extern int		ds_x2;
-
-extern lighttable_t*	ds_colormap;
-
-extern fixed_t		ds_xfrac;
-extern fixed_t		ds_yfrac;
-extern fixed_t		ds_xstep;
-extern fixed_t		ds_ystep;
-
-// start of a 64*64 tile image
-extern byte*		ds_source;		
-
 extern byte*		translationtables;
-extern byte*		dc_translation;
 
 
 // Span blitting for rows, floor/ceiling.
 // No Sepctre effect needed.
-void 	R_DrawSpan (void);
+void 	R_DrawSpan (drawcontext_t *ds);
 
 // Low resolution mode, 160x200?
-void 	R_DrawSpanLow (void);
+void 	R_DrawSpanLow (drawcontext_t *ds);
 
 
 void
@@ -28,11 +28,16 @@
 #include "doomdef.h"
 #include "doomstat.h" // [AM] leveltime, paused, menuactive
 #include "d_loop.h"
+#include "i_simd.h"
+#include "i_thread.h"
+#include "m_argv.h"
 #include "m_bbox.h"
+#include "m_bench.h"
 #include "m_menu.h"
 #include "p_local.h"
 #include "r_local.h"
 #include "r_sky.h"
+#include "v_video.h"
 #include "g_game.h"
 #include "crispy.h"
 #include "jn.h"
@@ -122,12 +127,12 @@ lighttable_t* fullbright_redonly2[LIGHTLEVELS][MAXLIGHTSCALE];
 int extralight;			
 
 
-void (*colfunc) (void);
-void (*basecolfunc) (void);
-void (*fuzzcolfunc) (void);
-void (*transcolfunc) (void);
-void (*tlcolfunc) (void);
-void (*spanfunc) (void);
+void (*colfunc) (drawcontext_t *dc);
+void (*basecolfunc) (drawcontext_t *dc);
+void (*fuzzcolfunc) (drawcontext_t *dc);
+void (*transcolfunc) (drawcontext_t *dc);
+void (*tlcolfunc) (drawcontext_t *dc);
+void (*spanfunc) (drawcontext_t *ds);
 
 
 //
@@ -772,6 +777,8 @@ void R_ExecuteSetViewSize (void)
 //
 void R_Init (void)
 {
+    int p;
+
     if (widescreen > 0)
     {
         // [JN] Wide screen: don't allow unsupported view modes at startup
@@ -781,6 +788,25 @@ void R_Init (void)
             screenblocks = 14;
     }
 
+    //!
+    // @arg <n>
+    // @category video
+    //
+    // Draw floors and ceilings with n threads, each one covering
+    // its own vertical strip of the view. Texture lookups are built
+    // on the same threads at startup.
+    //
+
+    p = M_CheckParmWithArgs("-rthreads", 1);
+
+    if (p)
+    {
+        render_threads = atoi(myargv[p + 1]);
+    }
+
+    // [JN] Start the workers first, texture lookups are built on them.
+    I_InitThreads(render_threads);
+
     R_InitData ();
     printf (".");
     R_SetViewSize (screenblocks, detailLevel);  // viewwidth / viewheight / detailLevel are set by the defaults
@@ -791,6 +817,16 @@ void R_Init (void)
     printf (".");
     R_InitTranslationTables ();
     printf (".");
+    I_InitSIMD ();
+
+    //!
+    // @category video
+    //
+    // Collect the floor and ceiling spans of every frame and draw
+    // them grouped by flat and colormap.
+    //
+
+    batchspans = M_ParmExists("-batchspans");
 
     framecount = 0;
 }
@@ -940,12 +976,14 @@ void R_SetupFrame (player_t* player)
 //
 void R_RenderPlayerView (player_t* player)
 {	
-    extern void V_DrawFilledBox (int x, int y, int w, int h, int c);
     extern void R_InterpolateTextureOffsets (void);
     extern boolean beneath_door;
 
     R_SetupFrame (player);
 
+    // [JN] The view window is redrawn every frame.
+    V_MarkRect(viewwindowx, viewwindowy, scaledviewwidth, scaledviewheight);
+
     // Clear buffers.
     R_ClearClipSegs ();
     R_ClearDrawSegs ();
@@ -975,12 +1013,16 @@ void R_RenderPlayerView (player_t* player)
     R_InterpolateTextureOffsets();
 
     // The head node is the last node output.
+    M_BenchBegin(bench_bsp);
     R_RenderBSPNode (numnodes-1);
+    M_BenchEnd(bench_bsp);
 
     // Check for new console commands.
     NetUpdate ();
 
+    M_BenchBegin(bench_planes);
     R_DrawPlanes ();
+    M_BenchEnd(bench_planes);
 
     // Check for new console commands.
     NetUpdate ();
@@ -990,7 +1032,9 @@ void R_RenderPlayerView (player_t* player)
     if (!vanillaparm)
     R_SetFuzzPosDraw();
 
+    M_BenchBegin(bench_masked);
     R_DrawMasked ();
+    M_BenchEnd(bench_masked);
 
     // Check for new console commands.
     NetUpdate ();				
@@ -45,6 +45,8 @@ extern int validcount;
 extern int linecount;
 extern int loopcount;
 
+extern int render_threads;  // [JN] Threads drawing floors and ceilings
+
 
 //
 // Lighting LUT.
@@ -118,13 +120,13 @@ extern int detailshift;
 // Function pointers to switch refresh/drawing functions.
 // Used to select shadow mode etc.
 //
-extern void	(*colfunc) (void);
-extern void	(*transcolfunc) (void);
-extern void	(*basecolfunc) (void);
-extern void	(*fuzzcolfunc) (void);
-extern void	(*tlcolfunc) (void);
+extern void	(*colfunc) (drawcontext_t *dc);
+extern void	(*transcolfunc) (drawcontext_t *dc);
+extern void	(*basecolfunc) (drawcontext_t *dc);
+extern void	(*fuzzcolfunc) (drawcontext_t *dc);
+extern void	(*tlcolfunc) (drawcontext_t *dc);
 // No shadow effects on floors.
-extern void (*spanfunc) (void);
+extern void (*spanfunc) (drawcontext_t *ds);
 
 
 //
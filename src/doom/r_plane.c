@@ -25,6 +25,8 @@
 #include <stdlib.h>
 
 #include "i_system.h"
+#include "i_thread.h"
+#include "i_timer.h"
 #include "z_zone.h"
 #include "w_wad.h"
 #include "doomdef.h"
@@ -54,6 +56,17 @@ visplane_t*     floorplane;
 visplane_t*     ceilingplane;
 static int	    numvisplanes;
 
+// [JN] Hash index over visplanes, keyed on (height, picnum, lightlevel).
+// Only the first visplane of every key is linked in, so R_FindPlane
+// returns exactly the same plane as the old linear search did.
+// Chains hold array indices, as R_RaiseVisplanes may move the array.
+#define VISPLANEHASHSIZE 512
+#define visplane_hash(picnum,lightlevel,height) \
+    (((unsigned int)(picnum)*3+(unsigned int)(lightlevel)+(unsigned int)(height)*7) & (VISPLANEHASHSIZE-1))
+static int visplanehash[VISPLANEHASHSIZE];
+
+int rendered_visplanes; // [JN] Visplanes used in last frame
+
 // ?
 #define MAXOPENINGS WIDESCREENWIDTH*64*4 
 int     openings[MAXOPENINGS]; // [crispy] 32-bit integer math
@@ -72,14 +85,16 @@ int ceilingclip[WIDESCREENWIDTH]; // [crispy] 32-bit integer math
 // spanstart holds the start of a plane span
 // initialized to 0 at start
 //
-int spanstart[SCREENHEIGHT];
-int spanstop[SCREENHEIGHT];
+// [JN] Span and texture mapping state below is thread local,
+// as every render thread draws its own strip of the view.
+//
+static THREADLOCAL int spanstart[SCREENHEIGHT];
 
 //
 // texture mapping
 //
-lighttable_t**		planezlight;
-fixed_t			planeheight;
+static THREADLOCAL lighttable_t**	planezlight;
+static THREADLOCAL fixed_t		planeheight;
 
 fixed_t* yslope;
 fixed_t yslopes[LOOKDIRS][SCREENHEIGHT];
@@ -87,10 +102,52 @@ fixed_t distscale[WIDESCREENWIDTH];
 fixed_t basexscale;
 fixed_t baseyscale;
 
-fixed_t cachedheight[SCREENHEIGHT];
-fixed_t cacheddistance[SCREENHEIGHT];
-fixed_t cachedxstep[SCREENHEIGHT];
-fixed_t cachedystep[SCREENHEIGHT];
+static THREADLOCAL fixed_t cachedheight[SCREENHEIGHT];
+static THREADLOCAL fixed_t cacheddistance[SCREENHEIGHT];
+static THREADLOCAL fixed_t cachedxstep[SCREENHEIGHT];
+static THREADLOCAL fixed_t cachedystep[SCREENHEIGHT];
+
+// [JN] Flat data for every visplane and sky data for every view
+// column, resolved on the main thread before planes are drawn, as
+// neither the zone nor the lump cache may be used from render threads.
+static byte**   planesources = NULL;
+static int      numplanesources;
+static byte*    skysources[WIDESCREENWIDTH];
+static int      skylumps[WIDESCREENWIDTH];
+static int      numskylumps;
+static boolean  skycomposite;
+static int      numplanestrips;
+
+// [JN] Span batching. With -batchspans every strip collects its spans
+// first and then draws them grouped by flat and colormap, keeping one
+// flat hot in cache. Spans of a frame never overlap, so the order in
+// which they are drawn does not change the output.
+typedef struct
+{
+    byte*           source;
+    lighttable_t*   colormap;
+    int             y;
+    int             x1;
+    int             x2;
+    fixed_t         xfrac;
+    fixed_t         yfrac;
+    fixed_t         xstep;
+    fixed_t         ystep;
+} planespan_t;
+
+typedef struct
+{
+    planespan_t*    spans;
+    int             numspans;
+    int             maxspans;
+} spanbatch_t;
+
+boolean batchspans;
+static spanbatch_t spanbatches[MAXTHREADS];
+static THREADLOCAL spanbatch_t* spanbatch;
+
+int rendered_spans;     // [JN] Spans drawn in last frame
+int rendered_planetime; // [JN] Time spent drawing planes in last frame, us
 
 int detailLevel; // [JN] & [crispy] Необходимо для R_MapPlane
 
@@ -105,12 +162,40 @@ int detailLevel; // [JN] & [crispy] Необходимо для R_MapPlane
 // }
 
 
+//
+// R_DeferSpan
+// [JN] Queues a span for R_DrawSpanBatch.
+//
+static void R_DeferSpan (const drawcontext_t *ds)
+{
+    planespan_t*    span;
+
+    if (spanbatch->numspans == spanbatch->maxspans)
+    {
+        spanbatch->maxspans = spanbatch->maxspans ? spanbatch->maxspans * 2 : 1024;
+        spanbatch->spans = I_Realloc(spanbatch->spans,
+                                     spanbatch->maxspans * sizeof(*spanbatch->spans));
+    }
+
+    span = &spanbatch->spans[spanbatch->numspans++];
+    span->source = ds->source;
+    span->colormap = ds->colormap;
+    span->y = ds->y;
+    span->x1 = ds->x1;
+    span->x2 = ds->x2;
+    span->xfrac = ds->xfrac;
+    span->yfrac = ds->yfrac;
+    span->xstep = ds->xstep;
+    span->ystep = ds->ystep;
+}
+
+
 //
 // R_MapPlane
 //
 // Uses global vars:
 //  planeheight
-//  ds_source
+//  ds->source
 //  basexscale
 //  baseyscale
 //  viewx
@@ -118,7 +203,7 @@ int detailLevel; // [JN] & [crispy] Необходимо для R_MapPlane
 //
 // BASIC PRIMITIVE
 //
-void R_MapPlane (int y, int x1, int x2)
+void R_MapPlane (drawcontext_t *ds, int y, int x1, int x2)
 {
     // [crispy] see below
     //  angle_t	angle;
@@ -155,24 +240,24 @@ void R_MapPlane (int y, int x1, int x2)
     {
         cachedheight[y] = planeheight;
         distance = cacheddistance[y] = FixedMul (planeheight, yslope[y]);
-        ds_xstep = cachedxstep[y] = FixedMul (viewsin, planeheight) / dy;
-        ds_ystep = cachedystep[y] = FixedMul (viewcos, planeheight) / dy;
+        ds->xstep = cachedxstep[y] = FixedMul (viewsin, planeheight) / dy;
+        ds->ystep = cachedystep[y] = FixedMul (viewcos, planeheight) / dy;
     }
     else
     {
         distance = cacheddistance[y];
-        ds_xstep = cachedxstep[y];
-        ds_ystep = cachedystep[y];
+        ds->xstep = cachedxstep[y];
+        ds->ystep = cachedystep[y];
     }
 
     dx = x1 - centerx;
 
-    ds_xfrac = viewx + FixedMul(viewcos, distance) + dx * ds_xstep;
-    ds_yfrac = -viewy - FixedMul(viewsin, distance) + dx * ds_ystep;
+    ds->xfrac = viewx + FixedMul(viewcos, distance) + dx * ds->xstep;
+    ds->yfrac = -viewy - FixedMul(viewsin, distance) + dx * ds->ystep;
 
     if (fixedcolormap)
     {
-        ds_colormap = fixedcolormap;
+        ds->colormap = fixedcolormap;
     }
     else
     {
@@ -192,15 +277,24 @@ void R_MapPlane (int y, int x1, int x2)
                 index = MAXLIGHTZ-1;
         }
 
-        ds_colormap = planezlight[index];
+        ds->colormap = planezlight[index];
     }
 
-    ds_y = y;
-    ds_x1 = x1;
-    ds_x2 = x2;
+    ds->y = y;
+    ds->x1 = x1;
+    ds->x2 = x2;
 
-    // high or low detail
-    spanfunc ();	
+    if (batchspans)
+    {
+        R_DeferSpan(ds);
+    }
+    else
+    {
+        spanbatch->numspans++;
+
+        // high or low detail
+        spanfunc (ds);
+    }
 }
 
 
@@ -223,6 +317,9 @@ void R_ClearPlanes (void)
     lastvisplane = visplanes;
     lastopening = openings;
 
+    // [JN] Empty the visplane hash
+    memset (visplanehash, -1, sizeof(visplanehash));
+
     // texture calculation
     memset (cachedheight, 0, sizeof(cachedheight));
 
@@ -270,7 +367,9 @@ static void R_RaiseVisplanes (visplane_t** vp)
 visplane_t*
 R_FindPlane (fixed_t height, int picnum, int lightlevel)
 {
-    visplane_t* check;
+    visplane_t*  check;
+    int          i;
+    unsigned int hash;
 
     if (picnum == skyflatnum)
     {
@@ -278,17 +377,19 @@ R_FindPlane (fixed_t height, int picnum, int lightlevel)
         lightlevel = 0;
     }
 
-    for (check=visplanes; check<lastvisplane; check++)
+    hash = visplane_hash(picnum, lightlevel, height);
+
+    for (i = visplanehash[hash] ; i != -1 ; i = check->next)
     {
+        check = visplanes + i;
+
         if (height == check->height && picnum == check->picnum && lightlevel == check->lightlevel)
         {
-            break;
+            return check;
         }
     }
 
-    if (check < lastvisplane)
-    return check;
-
+    check = lastvisplane;
     R_RaiseVisplanes(&check);
 
     lastvisplane++;
@@ -299,6 +400,10 @@ R_FindPlane (fixed_t height, int picnum, int lightlevel)
     check->minx = WIDESCREENWIDTH;
     check->maxx = -1;
 
+    // [JN] Link new key into the hash
+    check->next = visplanehash[hash];
+    visplanehash[hash] = check - visplanes;
+
     memset (check->top,0xff,sizeof(check->top));
 
     return check;
@@ -377,7 +482,7 @@ R_CheckPlane (visplane_t* pl, int start, int stop)
 // R_MakeSpans
 //
 void
-R_MakeSpans (int x, 
+R_MakeSpans (drawcontext_t *ds, int x, 
 unsigned int		t1, // [crispy] 32-bit integer math
 unsigned int		b1, // [crispy] 32-bit integer math
 unsigned int		t2, // [crispy] 32-bit integer math
@@ -386,12 +491,12 @@ unsigned int		b2  // [crispy] 32-bit integer math
 {
     while (t1 < t2 && t1<=b1)
     {
-        R_MapPlane (t1,spanstart[t1],x-1);
+        R_MapPlane (ds,t1,spanstart[t1],x-1);
         t1++;
     }
     while (b1 > b2 && b1>=t1)
     {
-        R_MapPlane (b1,spanstart[b1],x-1);
+        R_MapPlane (ds,b1,spanstart[b1],x-1);
         b1--;
     }
 
@@ -409,52 +514,102 @@ unsigned int		b2  // [crispy] 32-bit integer math
 
 
 //
-// R_DrawPlanes
-// At the end of each frame.
+// R_CompareSpans
+// [JN] Sort order of batched spans: flat, then colormap, then row.
 //
-void R_DrawPlanes (void) 
+static int R_CompareSpans (const void *a, const void *b)
+{
+    const planespan_t *sa = a;
+    const planespan_t *sb = b;
+
+    if (sa->source != sb->source)
+    {
+        return (uintptr_t) sa->source < (uintptr_t) sb->source ? -1 : 1;
+    }
+
+    if (sa->colormap != sb->colormap)
+    {
+        return (uintptr_t) sa->colormap < (uintptr_t) sb->colormap ? -1 : 1;
+    }
+
+    return sa->y - sb->y;
+}
+
+
+//
+// R_DrawSpanBatch
+// [JN] Draws all spans queued by a strip, grouped by flat and colormap.
+//
+static void R_DrawSpanBatch (spanbatch_t *batch)
+{
+    planespan_t*    span;
+    planespan_t*    end;
+    drawcontext_t   ds;
+
+    qsort(batch->spans, batch->numspans, sizeof(*batch->spans), R_CompareSpans);
+
+    end = batch->spans + batch->numspans;
+
+    for (span = batch->spans ; span < end ; span++)
+    {
+        ds.source = span->source;
+        ds.colormap = span->colormap;
+        ds.y = span->y;
+        ds.x1 = span->x1;
+        ds.x2 = span->x2;
+        ds.xfrac = span->xfrac;
+        ds.yfrac = span->yfrac;
+        ds.xstep = span->xstep;
+        ds.ystep = span->ystep;
+
+        spanfunc (&ds);
+    }
+}
+
+
+//
+// R_DrawPlanesStrip
+// [JN] Draws all visplanes clipped to one vertical strip of the view.
+// Spans are cut at the strip edges, but every pixel gets the same
+// texture coordinates as in a single pass, so output is identical.
+//
+static void R_DrawPlanesStrip (void *data, int strip)
 {
     visplane_t* pl;
     int         light;
     int         x;
+    int         xl;
+    int         xh;
+    int         start;
     int         stop;
-    int         angle;
-    int         lumpnum;
+    drawcontext_t dc;
 
-#ifdef RANGECHECK
-    if (ds_p - drawsegs > numdrawsegs)
-    I_Error (english_language ?
-             "R_DrawPlanes: drawsegs overflow (%i)" :
-             "R_DrawPlanes: переполнение 'drawsegs' (%i)",
-             ds_p - drawsegs);
+    xl = viewwidth * strip / numplanestrips;
+    xh = viewwidth * (strip + 1) / numplanestrips - 1;
 
-    if (lastvisplane - visplanes > numvisplanes)
-    I_Error (english_language ?
-             "R_DrawPlanes: visplane overflow (%i)" :
-             "R_DrawPlanes: переполнение 'visplane' (%i)",
-             lastvisplane - visplanes);
+    // texture calculation, own cache for every thread
+    memset (cachedheight, 0, sizeof(cachedheight));
 
-    if (lastopening - openings > MAXOPENINGS)
-    I_Error (english_language ?
-             "R_DrawPlanes: opening overflow (%i)" :
-             "R_DrawPlanes: переполнение 'opening' (%i)",
-             lastopening - openings);
-#endif
+    spanbatch = &spanbatches[strip];
+    spanbatch->numspans = 0;
 
     for (pl = visplanes ; pl < lastvisplane ; pl++)
     {
-        if (pl->minx > pl->maxx)
+        start = pl->minx > xl ? pl->minx : xl;
+        stop = pl->maxx < xh ? pl->maxx : xh;
+
+        if (start > stop)
         continue;
 
         // sky flat
         if (pl->picnum == skyflatnum)
         {
             // [JN] Original:
-            dc_iscale = pspriteiscale>>(detailshift && !hires);
+            dc.iscale = pspriteiscale>>(detailshift && !hires);
             
             // [JN] Mouselook addition
             if (mlook && scaled_sky)
-            dc_iscale = dc_iscale / 2;
+            dc.iscale = dc.iscale / 2;
 
             // Sky is allways drawn full bright,
             //  i.e. colormaps[0] is used.
@@ -463,35 +618,30 @@ void R_DrawPlanes (void)
 
             // [JN] Окрашивание неба при неузязвимости.
             if (invul_sky && !vanillaparm)
-            dc_colormap = (fixedcolormap ? fixedcolormap : colormaps);
+            dc.colormap = (fixedcolormap ? fixedcolormap : colormaps);
             else
-            dc_colormap = colormaps;
+            dc.colormap = colormaps;
 
-            dc_texturemid = skytexturemid;
-            dc_texheight = textureheight[skytexture]>>FRACBITS;
+            dc.texturemid = skytexturemid;
+            dc.texheight = textureheight[skytexture]>>FRACBITS;
 
-            for (x=pl->minx ; x <= pl->maxx ; x++)
+            for (x=start ; x <= stop ; x++)
             {
-                dc_yl = pl->top[x];
-                dc_yh = pl->bottom[x];
+                dc.yl = pl->top[x];
+                dc.yh = pl->bottom[x];
 
-                if ((unsigned) dc_yl <= dc_yh) // [crispy] 32-bit integer math
+                if ((unsigned) dc.yl <= dc.yh) // [crispy] 32-bit integer math
                 {
-                    angle = (viewangle + xtoviewangle[x])>>ANGLETOSKYSHIFT;
-                    dc_x = x;
-                    dc_source = R_GetColumn(skytexture, angle, false);
-                    colfunc ();
+                    dc.x = x;
+                    dc.source = skysources[x];
+                    colfunc (&dc);
                 }
             }
         continue;
         }
 
         // regular flat
-        lumpnum = firstflat + flattranslation[pl->picnum];
-        // [crispy] add support for SMMU swirling flats
-        ds_source = (flattranslation[pl->picnum] == -1) ?
-                    R_DistortedFlat(pl->picnum) :
-                    W_CacheLumpNum(lumpnum, PU_STATIC);
+        dc.source = planesources[pl - visplanes];
 
         planeheight = abs(pl->height-viewz);
         light = ((pl->lightlevel+level_brightness) >> LIGHTSEGSHIFT)+extralight;
@@ -507,32 +657,134 @@ void R_DrawPlanes (void)
         // [JN] Apply brightmaps to floor/ceiling...
         if (brightmaps && !vanillaparm && gamevariant != freedoom && gamevariant != freedm)
         {
-            if (pl->picnum == bmapflatnum1  // CONS1_1
-            ||  pl->picnum == bmapflatnum2  // CONS1_5
-            ||  pl->picnum == bmapflatnum3) // CONS1_7
-            planezlight = fullbright_notgrayorbrown_floor[light];
-
-            if (pl->picnum == bmapflatnum4) // GATE6
-            planezlight = fullbright_orangeyellow_floor[light];
+            planezlight = flatbrightmap[pl->picnum][light];
         }
 
-        pl->top[pl->maxx+1] = 0xffffffffu; // [crispy] hires / 32-bit integer math
-        pl->top[pl->minx-1] = 0xffffffffu; // [crispy] hires / 32-bit integer math
+        // [JN] Columns outside of the strip act as the empty
+        // [minx-1]/[maxx+1] pads, the visplane itself is shared.
+        R_MakeSpans(&dc, start, 0xffffffffu, 0, pl->top[start], pl->bottom[start]);
 
-        stop = pl->maxx + 1;
-
-        for (x=pl->minx ; x<= stop ; x++)
+        for (x=start+1 ; x<= stop ; x++)
         {
-            R_MakeSpans(x,pl->top[x-1],
+            R_MakeSpans(&dc, x,pl->top[x-1],
             pl->bottom[x-1],
             pl->top[x],
             pl->bottom[x]);
         }
 
+        R_MakeSpans(&dc, stop+1, pl->top[stop], pl->bottom[stop], 0xffffffffu, 0);
+    }
+
+    if (batchspans)
+    {
+        R_DrawSpanBatch(spanbatch);
+    }
+}
+
+
+//
+// R_DrawPlanes
+// At the end of each frame.
+//
+void R_DrawPlanes (void) 
+{
+    visplane_t* pl;
+    int         i;
+    int         x;
+    int         angle;
+    uint64_t    planetime;
+
+#ifdef RANGECHECK
+    if (ds_p - drawsegs > numdrawsegs)
+    I_Error (english_language ?
+             "R_DrawPlanes: drawsegs overflow (%i)" :
+             "R_DrawPlanes: переполнение 'drawsegs' (%i)",
+             ds_p - drawsegs);
+
+    if (lastvisplane - visplanes > numvisplanes)
+    I_Error (english_language ?
+             "R_DrawPlanes: visplane overflow (%i)" :
+             "R_DrawPlanes: переполнение 'visplane' (%i)",
+             lastvisplane - visplanes);
+
+    if (lastopening - openings > MAXOPENINGS)
+    I_Error (english_language ?
+             "R_DrawPlanes: opening overflow (%i)" :
+             "R_DrawPlanes: переполнение 'opening' (%i)",
+             lastopening - openings);
+#endif
+
+    rendered_visplanes = lastvisplane - visplanes;
+
+    if (numplanesources < numvisplanes)
+    {
+        numplanesources = numvisplanes;
+        planesources = I_Realloc(planesources, numplanesources * sizeof(*planesources));
+    }
+
+    // [JN] Resolve flats and sky columns first.
+    numskylumps = 0;
+    skycomposite = false;
+
+    for (pl = visplanes ; pl < lastvisplane ; pl++)
+    {
+        if (pl->minx > pl->maxx)
+        continue;
+
+        if (pl->picnum == skyflatnum)
+        {
+            for (x=pl->minx ; x <= pl->maxx ; x++)
+            {
+                if (pl->top[x] <= pl->bottom[x])
+                {
+                    angle = (viewangle + xtoviewangle[x])>>ANGLETOSKYSHIFT;
+                    skysources[x] = R_CacheColumn(skytexture, angle, &i);
+
+                    if (i == -1)
+                    skycomposite = true;
+                    else if (!numskylumps || skylumps[numskylumps-1] != i)
+                    skylumps[numskylumps++] = i;
+                }
+            }
+            continue;
+        }
+
         // [crispy] add support for SMMU swirling flats
-        if (flattranslation[pl->picnum] != -1)
+        planesources[pl - visplanes] = (flattranslation[pl->picnum] == -1) ?
+                    (byte *) R_DistortedFlat(pl->picnum) :
+                    W_CacheLumpNum(firstflat + flattranslation[pl->picnum], PU_STATIC);
+    }
+
+    // [JN] Split the view into a strip for every render thread.
+    numplanestrips = I_NumThreads();
+    planetime = I_GetTimeUS();
+    I_RunParallel(R_DrawPlanesStrip, NULL, numplanestrips);
+    rendered_planetime = (int) (I_GetTimeUS() - planetime);
+
+    rendered_spans = 0;
+
+    for (i = 0 ; i < numplanestrips ; i++)
+    {
+        rendered_spans += spanbatches[i].numspans;
+    }
+
+    for (pl = visplanes ; pl < lastvisplane ; pl++)
+    {
+        // [crispy] add support for SMMU swirling flats
+        if (pl->minx <= pl->maxx && pl->picnum != skyflatnum
+        &&  flattranslation[pl->picnum] != -1)
         {
-            W_ReleaseLumpNum(lumpnum);
+            W_ReleaseLumpNum(firstflat + flattranslation[pl->picnum]);
         }
     }
+
+    for (i = 0 ; i < numskylumps ; i++)
+    {
+        W_ReleaseLumpNum(skylumps[i]);
+    }
+
+    if (skycomposite)
+    {
+        R_ReleaseComposite(skytexture);
+    }
 }
@@ -40,13 +40,20 @@ extern fixed_t*	yslope;
 extern fixed_t yslopes[LOOKDIRS][SCREENHEIGHT];
 extern fixed_t distscale[WIDESCREENWIDTH];
 
+extern int rendered_visplanes; // [JN] Visplanes used in last frame
+extern int rendered_spans;     // [JN] Spans drawn in last frame
+extern int rendered_planetime; // [JN] Time spent drawing planes in last frame, us
+
+extern boolean batchspans;     // [JN] Draw spans grouped by flat and colormap
+
 // void R_InitPlanes (void);
 void R_ClearPlanes (void);
 
 
-void R_MapPlane (int y, int x1, int x2);
+void R_MapPlane (drawcontext_t *ds, int y, int x1, int x2);
 void R_MakeSpans 
-(   int             x,
+(   drawcontext_t  *ds,
+    int             x,
     unsigned int    t1, // [crispy] 32-bit integer math
     unsigned int    b1, // [crispy] 32-bit integer math
     unsigned int    t2, // [crispy] 32-bit integer math
@@ -37,8 +37,12 @@
 #define SEQUENCE 1024
 #define FLATSIZE (64 * 64)
 
-static int *offsets;
-static int *offset;
+// [JN] Offsets are built for the current tic only, instead of keeping
+// all SEQUENCE frames (16 MB) around from startup. Every offset is a
+// sum of sines of x alone and of y alone, so four 64 entry rows per tic
+// give exactly the values of the full table.
+static int offset[FLATSIZE];
+static int offsettic = -1;
 
 extern int firstflat;
 
@@ -46,69 +50,78 @@ extern int firstflat;
 #define AMP2 2
 #define SPEED 40
 
-void R_InitDistortedFlats()
+static void R_BuildDistortion(int i)
 {
-	if (!offsets)
+	int xofs_x[64], xofs_y[64];
+	int yofs_x[64], yofs_y[64];
+	int x, y;
+
+	for (x = 0; x < 64; x++)
 	{
-		int i;
+		xofs_x[x] = x + 128
+		          + ((finesine[(x * swirlfactor2 + i * SPEED * 4 + 300) & 8191] * AMP2) >> FRACBITS);
+		yofs_x[x] = ((finesine[(x * swirlfactor + i * SPEED * 3 + 700) & 8191] * AMP) >> FRACBITS);
+	}
 
-		offsets = I_Realloc(NULL, SEQUENCE * FLATSIZE * sizeof(*offsets));
-		offset = offsets;
+	for (y = 0; y < 64; y++)
+	{
+		xofs_y[y] = ((finesine[(y * swirlfactor + i * SPEED * 5 + 900) & 8191] * AMP) >> FRACBITS);
+		yofs_y[y] = y + 128
+		          + ((finesine[(y * swirlfactor2 + i * SPEED * 4 + 1200) & 8191] * AMP2) >> FRACBITS);
+	}
 
-		for (i = 0; i < SEQUENCE; i++)
+	for (y = 0; y < 64; y++)
+	{
+		for (x = 0; x < 64; x++)
 		{
-			int x, y;
-
-			for (x = 0; x < 64; x++)
-			{
-				for (y = 0; y < 64; y++)
-				{
-					int x1, y1;
-					int sinvalue, sinvalue2;
-
-					sinvalue = (y * swirlfactor + i * SPEED * 5 + 900) & 8191;
-					sinvalue2 = (x * swirlfactor2 + i * SPEED * 4 + 300) & 8191;
-					x1 = x + 128
-					   + ((finesine[sinvalue] * AMP) >> FRACBITS)
-					   + ((finesine[sinvalue2] * AMP2) >> FRACBITS);
-
-					sinvalue = (x * swirlfactor + i * SPEED * 3 + 700) & 8191;
-					sinvalue2 = (y * swirlfactor2 + i * SPEED * 4 + 1200) & 8191;
-					y1 = y + 128
-					   + ((finesine[sinvalue] * AMP) >> FRACBITS)
-					   + ((finesine[sinvalue2] * AMP2) >> FRACBITS);
-
-					x1 &= 63;
-					y1 &= 63;
-
-					offset[(y << 6) + x] = (y1 << 6) + x1;
-				}
-			}
-
-			offset += FLATSIZE;
+			int x1 = (xofs_x[x] + xofs_y[y]) & 63;
+			int y1 = (yofs_x[x] + yofs_y[y]) & 63;
+
+			offset[(y << 6) + x] = (y1 << 6) + x1;
 		}
 	}
 }
 
 char *R_DistortedFlat(int flatnum)
 {
-	static int swirltic = -1;
-	static int swirlflat = -1;
-	static char distortedflat[FLATSIZE];
-
-	if (swirltic != leveltime)
+	// [JN] Keep a buffer for every swirling flat, regenerated once per
+	// tic, so several liquids in view no longer overwrite each other's
+	// copy and planes may be drawn from them in any order.
+	extern int numflats;
+	static char **distortedflats = NULL;
+	static int *distortedtics = NULL;
+
+	if (!distortedflats)
 	{
-		offset = offsets + ((leveltime & (SEQUENCE - 1)) * FLATSIZE);
+		int i;
 
-		swirltic = leveltime;
-		swirlflat = -1;
+		distortedflats = Z_Malloc(numflats * sizeof(*distortedflats), PU_STATIC, 0);
+		distortedtics = Z_Malloc(numflats * sizeof(*distortedtics), PU_STATIC, 0);
+
+		for (i = 0; i < numflats; i++)
+		{
+			distortedflats[i] = NULL;
+			distortedtics[i] = -1;
+		}
 	}
 
-	if (swirlflat != flatnum)
+	if (!distortedflats[flatnum])
+	{
+		distortedflats[flatnum] = Z_Malloc(FLATSIZE, PU_STATIC, 0);
+	}
+
+	if (distortedtics[flatnum] != leveltime)
 	{
 		char *normalflat;
+		char *distortedflat = distortedflats[flatnum];
 		int i;
 
+		if (offsettic != leveltime)
+		{
+			R_BuildDistortion(leveltime & (SEQUENCE - 1));
+			offsettic = leveltime;
+		}
+
         // [JN] Use defined flat
 		// normalflat = W_CacheLumpNum(flatnum, PU_STATIC);
         normalflat = W_CacheLumpNum(firstflat + flatnum, PU_LEVEL);
@@ -118,10 +131,10 @@ char *R_DistortedFlat(int flatnum)
 			distortedflat[i] = normalflat[offset[i]];
 		}
 
-		Z_ChangeTag(normalflat, PU_CACHE);
+		W_ReleaseLumpNum(firstflat + flatnum);
 
-		swirlflat = flatnum;
+		distortedtics[flatnum] = leveltime;
 	}
 
-	return distortedflat;
+	return distortedflats[flatnum];
 }
@@ -115,7 +115,36 @@ int*            mceilingclip;
 fixed_t         spryscale;
 int64_t         sprtopscreen; // [crispy] WiggleFix
 
-vissprite_t     vsprsortedhead;
+// [JN] Vissprites sorted by scale, see R_SortVisSprites
+static vissprite_t* vissprite_ptrs[MAXVISSPRITES];
+static vissprite_t* vissprite_tmp[MAXVISSPRITES];
+static int          num_vissprite;
+
+// [JN] Drawsegs that can clip sprites, bucketed by screen x for
+// R_DrawSprite. Level l splits the view into 1<<l equal parts, and
+// each part lists the drawsegs overlapping it, last drawseg first,
+// which is the order the old scan of the whole array used.
+#define DSLEVELS    5
+#define DSBUCKETS   ((1 << DSLEVELS) - 1)
+
+typedef struct
+{
+    int         x1;
+    int         x2;
+    fixed_t     scale;      // larger of scale1 and scale2
+    fixed_t     lowscale;   // smaller of scale1 and scale2
+    drawseg_t*  ds;
+} dsrange_t;
+
+typedef struct
+{
+    dsrange_t*  ranges;
+    int         count;
+    int         max;
+} dsbucket_t;
+
+// Part i of level l is dsbuckets[(1 << l) - 1 + i].
+static dsbucket_t dsbuckets[DSBUCKETS];
 
 // CODE ====================================================================
 
@@ -385,15 +414,15 @@ vissprite_t* R_NewVisSprite (void)
 //
 // -------------------------------------------------------------------------
 
-void R_DrawMaskedColumn (column_t* column)
+void R_DrawMaskedColumn (drawcontext_t* dc, column_t* column)
 {
     int64_t	topscreen; // [crispy] WiggleFix
     int64_t 	bottomscreen; // [crispy] WiggleFix
     fixed_t	basetexturemid;
     int		top = -1;
 	
-    basetexturemid = dc_texturemid;
-    dc_texheight = 0; // [crispy] Tutti-Frutti fix
+    basetexturemid = dc->texturemid;
+    dc->texheight = 0; // [crispy] Tutti-Frutti fix
 	
     for ( ; column->topdelta != 0xff ; ) 
     {
@@ -411,28 +440,28 @@ void R_DrawMaskedColumn (column_t* column)
 	topscreen = sprtopscreen + spryscale*top;
 	bottomscreen = topscreen + spryscale*column->length;
 
-	dc_yl = (int)((topscreen+FRACUNIT-1)>>FRACBITS); // [crispy] WiggleFix
-	dc_yh = (int)((bottomscreen-1)>>FRACBITS); // [crispy] WiggleFix
+	dc->yl = (int)((topscreen+FRACUNIT-1)>>FRACBITS); // [crispy] WiggleFix
+	dc->yh = (int)((bottomscreen-1)>>FRACBITS); // [crispy] WiggleFix
 		
-	if (dc_yh >= mfloorclip[dc_x])
-	    dc_yh = mfloorclip[dc_x]-1;
-	if (dc_yl <= mceilingclip[dc_x])
-	    dc_yl = mceilingclip[dc_x]+1;
+	if (dc->yh >= mfloorclip[dc->x])
+	    dc->yh = mfloorclip[dc->x]-1;
+	if (dc->yl <= mceilingclip[dc->x])
+	    dc->yl = mceilingclip[dc->x]+1;
 
-	if (dc_yl <= dc_yh)
+	if (dc->yl <= dc->yh)
 	{
-	    dc_source = (byte *)column + 3;
-	    dc_texturemid = basetexturemid - (top<<FRACBITS);
-	    // dc_source = (byte *)column + 3 - top;
+	    dc->source = (byte *)column + 3;
+	    dc->texturemid = basetexturemid - (top<<FRACBITS);
+	    // dc->source = (byte *)column + 3 - top;
 
 	    // Drawn by either R_DrawColumn
 	    //  or (SHADOW) R_DrawFuzzColumn.
-	    colfunc ();	
+	    colfunc (dc);	
 	}
 	column = (column_t *)(  (byte *)column + column->length + 4);
     }
 	
-    dc_texturemid = basetexturemid;
+    dc->texturemid = basetexturemid;
 }
 
 // -------------------------------------------------------------------------
@@ -448,12 +477,13 @@ void R_DrawVisSprite (vissprite_t* vis, int x1, int x2)
     int         texturecolumn;
     fixed_t     frac;
     patch_t*    patch;
+    drawcontext_t dc;
 
     patch = W_CacheLumpNum (vis->patch+firstspritelump, PU_CACHE);
 
-    dc_colormap = vis->colormap;
+    dc.colormap = vis->colormap;
 
-    if (!dc_colormap)
+    if (!dc.colormap)
     {
         // NULL colormap = shadow draw
         colfunc = fuzzcolfunc;
@@ -461,12 +491,12 @@ void R_DrawVisSprite (vissprite_t* vis, int x1, int x2)
     else if (vis->mobjflags & MF_TRANSLATION)
     {
         colfunc = transcolfunc;
-        dc_translation = translationtables - 256 + ((vis->mobjflags & MF_TRANSLATION) >> (MF_TRANSSHIFT-8));
+        dc.translation = translationtables - 256 + ((vis->mobjflags & MF_TRANSLATION) >> (MF_TRANSSHIFT-8));
     }
     else if (vis->translation)
     {
         colfunc = transcolfunc;
-        dc_translation = vis->translation;
+        dc.translation = vis->translation;
     }
 
     // [crispy] translucent sprites
@@ -475,13 +505,13 @@ void R_DrawVisSprite (vissprite_t* vis, int x1, int x2)
         colfunc = tlcolfunc;
     }
 
-    dc_iscale = abs(vis->xiscale)>>(detailshift && !hires);
-    dc_texturemid = vis->texturemid;
+    dc.iscale = abs(vis->xiscale)>>(detailshift && !hires);
+    dc.texturemid = vis->texturemid;
     frac = vis->startfrac;
     spryscale = vis->scale;
-    sprtopscreen = centeryfrac - FixedMul(dc_texturemid,spryscale);
+    sprtopscreen = centeryfrac - FixedMul(dc.texturemid,spryscale);
 
-    for (dc_x=vis->x1 ; dc_x<=vis->x2 ; dc_x++, frac += vis->xiscale)
+    for (dc.x=vis->x1 ; dc.x<=vis->x2 ; dc.x++, frac += vis->xiscale)
     {
         texturecolumn = frac>>FRACBITS;
 #ifdef RANGECHECK
@@ -491,7 +521,7 @@ void R_DrawVisSprite (vissprite_t* vis, int x1, int x2)
                  "R_DrawSpriteRange: некорректныая информация texturecolumn");
 #endif
         column = (column_t *) ((byte *)patch + LONG(patch->columnofs[texturecolumn]));
-        R_DrawMaskedColumn (column);
+        R_DrawMaskedColumn (&dc, column);
     }
 
     colfunc = basecolfunc;
@@ -1182,55 +1212,132 @@ void R_DrawPlayerSprites (void)
 //
 // -------------------------------------------------------------------------
 
-void R_SortVisSprites (void)
+static void R_MergeSortVisSprites (vissprite_t** s, vissprite_t** t, int n)
 {
-    int             i;
-    int             count;
-    vissprite_t*    ds;
-    vissprite_t*    best;
-    vissprite_t     unsorted;
-    fixed_t         bestscale;
+    if (n >= 16)
+    {
+        int           n1 = n/2;
+        int           n2 = n - n1;
+        vissprite_t** s1 = s;
+        vissprite_t** s2 = s + n1;
+        vissprite_t** d = t;
+
+        R_MergeSortVisSprites(s1, t, n1);
+        R_MergeSortVisSprites(s2, t, n2);
+
+        // Only take from the right half when strictly nearer, so sprites
+        // of equal scale keep their original order.
+        while (n1 && n2)
+        {
+            if ((*s2)->scale < (*s1)->scale)
+            {
+                *d++ = *s2++;
+                n2--;
+            }
+            else
+            {
+                *d++ = *s1++;
+                n1--;
+            }
+        }
+
+        if (n2)
+            memcpy(d, s2, n2 * sizeof(*s2));
+        else
+            memcpy(d, s1, n1 * sizeof(*s1));
 
-    count         = vissprite_p - vissprites;
-    unsorted.next = unsorted.prev = &unsorted;
+        memcpy(s, t, n * sizeof(*s));
+    }
+    else
+    {
+        int          i, j;
+        vissprite_t* temp;
 
-    if (!count)
-    return;
+        // Straight insertion sort for short runs
+        for (i = 1 ; i < n ; i++)
+        {
+            temp = s[i];
 
-    for (ds=vissprites ; ds<vissprite_p ; ds++)
+            for (j = i ; j > 0 && temp->scale < s[j-1]->scale ; j--)
+            {
+                s[j] = s[j-1];
+            }
+
+            s[j] = temp;
+        }
+    }
+}
+
+void R_SortVisSprites (void)
+{
+    int i;
+
+    // [JN] Replaced O(n^2) selection sort with a stable merge sort.
+    // The original picked the first sprite of smallest scale on every
+    // pass, which is exactly a stable ascending sort, so the draw order
+    // (including ties) is unchanged.
+    num_vissprite = vissprite_p - vissprites;
+
+    for (i = 0 ; i < num_vissprite ; i++)
     {
-        ds->next = ds+1;
-        ds->prev = ds-1;
+        vissprite_ptrs[i] = vissprites + i;
     }
 
-    vissprites[0].prev = &unsorted;
-    unsorted.next = &vissprites[0];
-    (vissprite_p-1)->next = &unsorted;
-    unsorted.prev = vissprite_p-1;
+    R_MergeSortVisSprites(vissprite_ptrs, vissprite_tmp, num_vissprite);
+}
 
-    // pull the vissprites out by scale
+// -------------------------------------------------------------------------
+//
+// R_BucketDrawSegs
+// [JN] Fills dsbuckets from this frame's drawsegs.
+//
+// -------------------------------------------------------------------------
+
+static void R_BucketDrawSegs (void)
+{
+    int         i;
+    int         level;
+    int         first;
+    int         last;
+    drawseg_t*  ds;
+    dsbucket_t* bucket;
+    dsrange_t*  range;
 
-    vsprsortedhead.next = vsprsortedhead.prev = &vsprsortedhead;
-    for (i=0 ; i<count ; i++)
+    for (i = 0 ; i < DSBUCKETS ; i++)
     {
-        bestscale = INT_MAX;
-        best = unsorted.next;
+        dsbuckets[i].count = 0;
+    }
 
-        for (ds=unsorted.next ; ds != &unsorted ; ds=ds->next)
+    for (ds = ds_p ; ds-- > drawsegs ; )
+    {
+        // only these can clip or draw over a sprite
+        if (!ds->silhouette && !ds->maskedtexturecol)
+        continue;
+
+        for (level = 0 ; level < DSLEVELS ; level++)
         {
-            if (ds->scale < bestscale)
+            first = (ds->x1 << level) / viewwidth;
+            last = (ds->x2 << level) / viewwidth;
+
+            for (i = first ; i <= last ; i++)
             {
-            bestscale = ds->scale;
-            best = ds;
+                bucket = &dsbuckets[(1 << level) - 1 + i];
+
+                if (bucket->count == bucket->max)
+                {
+                    bucket->max = bucket->max ? bucket->max * 2 : 64;
+                    bucket->ranges = I_Realloc(bucket->ranges,
+                                               bucket->max * sizeof(*bucket->ranges));
+                }
+
+                range = &bucket->ranges[bucket->count++];
+                range->x1 = ds->x1;
+                range->x2 = ds->x2;
+                range->scale = ds->scale1 > ds->scale2 ? ds->scale1 : ds->scale2;
+                range->lowscale = ds->scale1 > ds->scale2 ? ds->scale2 : ds->scale1;
+                range->ds = ds;
             }
         }
-
-        best->next->prev = best->prev;
-        best->prev->next = best->next;
-        best->next = &vsprsortedhead;
-        best->prev = vsprsortedhead.prev;
-        vsprsortedhead.prev->next = best;
-        vsprsortedhead.prev = best;
     }
 }
 
@@ -1247,9 +1354,13 @@ void R_DrawSprite (vissprite_t* spr)
     int         x;
     int         r1;
     int         r2;
+    int         level;
     fixed_t     scale;
     fixed_t     lowscale;
     drawseg_t*  ds;
+    dsbucket_t* bucket;
+    dsrange_t*  range;
+    dsrange_t*  end;
     /* int      silhouette; // [JN] No longer unused */
 
     for (x = spr->x1 ; x<=spr->x2 ; x++)
@@ -1259,30 +1370,27 @@ void R_DrawSprite (vissprite_t* spr)
     // The first drawseg that has a greater scale
     //  is the clip seg.
 
-    // Modified by Lee Killough:
-    // (pointer check was originally nonportable
-    // and buggy, by going past LEFT end of array):
+    // [JN] Only walk the smallest bucket holding the whole sprite,
+    // it lists the drawsegs in the same end to start order.
+    level = DSLEVELS - 1;
 
-    // for (ds=ds_p-1 ; ds >= drawsegs ; ds--)    old buggy code
-    for (ds=ds_p ; ds-- > drawsegs ; )  // new -- killough
+    while (level > 0 && (spr->x1 << level) / viewwidth != (spr->x2 << level) / viewwidth)
+    level--;
+
+    bucket = &dsbuckets[(1 << level) - 1 + (spr->x1 << level) / viewwidth];
+    end = bucket->ranges + bucket->count;
+
+    for (range = bucket->ranges ; range < end ; range++)
     {   
         // determine if the drawseg obscures the sprite
-        if (ds->x1 > spr->x2 || ds->x2 < spr->x1 || (!ds->silhouette && !ds->maskedtexturecol))
+        if (range->x1 > spr->x2 || range->x2 < spr->x1)
         continue;   // does not cover sprite
 
-        r1 = ds->x1 < spr->x1 ? spr->x1 : ds->x1;
-        r2 = ds->x2 > spr->x2 ? spr->x2 : ds->x2;
-
-        if (ds->scale1 > ds->scale2)
-        {
-            lowscale = ds->scale2;
-            scale = ds->scale1;
-        }
-        else
-        {
-            lowscale = ds->scale1;
-            scale = ds->scale2;
-        }
+        ds = range->ds;
+        r1 = range->x1 < spr->x1 ? spr->x1 : range->x1;
+        r2 = range->x2 > spr->x2 ? spr->x2 : range->x2;
+        lowscale = range->lowscale;
+        scale = range->scale;
 
         if (scale < spr->scale || (lowscale < spr->scale && !R_PointOnSegSide (spr->gx, spr->gy, ds->curline)))
         {
@@ -1331,20 +1439,20 @@ void R_DrawSprite (vissprite_t* spr)
 
 void R_DrawMasked (void)
 {
-    vissprite_t*    spr;
+    int             i;
     drawseg_t*      ds;
 
     R_SortVisSprites();
 
-    if (vissprite_p > vissprites)
+    if (num_vissprite)
     {
-        // draw all vissprites back to front
-        for (spr = vsprsortedhead.next ; 
-            spr != &vsprsortedhead ;
-            spr=spr->next)
-        {
-            R_DrawSprite (spr);
-        }
+        R_BucketDrawSegs();
+    }
+
+    // draw all vissprites back to front
+    for (i = 0 ; i < num_vissprite ; i++)
+    {
+        R_DrawSprite (vissprite_ptrs[i]);
     }
 
     // render any remaining masked mid textures
@@ -30,7 +30,6 @@
 
 extern vissprite_t  vissprites[MAXVISSPRITES];
 extern vissprite_t* vissprite_p;
-extern vissprite_t  vsprsortedhead;
 
 // Constant arrays used for psprite clipping and initializing clipping.
 extern int negonearray[WIDESCREENWIDTH];
@@ -47,7 +46,7 @@ extern fixed_t pspriteiscale;
 
 // PUBLIC FUNCTION PROTOTYPES ----------------------------------------------
 
-void R_DrawMaskedColumn (column_t* column);
+void R_DrawMaskedColumn (drawcontext_t* dc, column_t* column);
 void R_SortVisSprites (void);
 void R_AddSprites (sector_t* sec);
 void R_AddPSprites (void);
@@ -29,6 +29,7 @@
 #include "i_system.h"
 #include "w_wad.h"
 #include "g_game.h"
+#include "p_setup.h"
 #include "r_local.h"
 #include "s_sound.h"
 #include "doomstat.h"
@@ -2152,6 +2153,9 @@ void WI_Start(wbstartstruct_t* wbstartstruct)
     WI_initVariables(wbstartstruct);
     WI_loadData();
 
+    // [JN] Warm up the next map while the stats are counted.
+    P_PrefetchLevel(wbstartstruct->epsd + 1, wbstartstruct->next + 1);
+
     if (deathmatch)
     WI_initDeathmatchStats();
     else if (netgame)
@@ -48,6 +48,7 @@
 #include "i_timer.h"
 #include "i_video.h"
 #include "m_argv.h"
+#include "m_bench.h"
 #include "m_config.h"
 #include "m_controls.h"
 #include "m_misc.h"
@@ -268,7 +269,9 @@ void D_Display(void)
     NetUpdate();
 
     // Flush buffered stuff to screen
+    M_BenchBegin(bench_finishupdate);
     I_FinishUpdate();
+    M_BenchEnd(bench_finishupdate);
 }
 
 //
@@ -329,11 +332,16 @@ void D_DoomLoop(void)
         }
 
         // Move positional sounds
+        M_BenchBegin(bench_sound);
         S_UpdateSounds(players[consoleplayer].mo);
+        M_BenchEnd(bench_sound);
 
         // Update display, next frame, with current state.
         if (screenvisible)
         D_Display();
+
+        // [JN] Close per-phase timings of -benchmark.
+        M_BenchFrame();
     }
 }
 
@@ -1248,6 +1256,20 @@ void D_DoomMain(void)
         p = M_CheckParmWithArgs("-timedemo", 1);
     }
 
+    if (!p)
+    {
+        //!
+        // @arg <demo>
+        // @category demo
+        //
+        // Play back the demo named demo.lmp as -timedemo does, timing
+        // the game and renderer phases of every frame. Prints min,
+        // median, 99th percentile and max of each phase; see -benchout.
+        //
+
+        p = M_CheckParmWithArgs("-benchmark", 1);
+    }
+
     if (p)
     {
         char *uc_filename = strdup(myargv[p + 1]);
@@ -1479,6 +1501,14 @@ void D_DoomMain(void)
         D_DoomLoop();           // Never returns
     }
 
+    p = M_CheckParmWithArgs("-benchmark", 1);
+    if (p)
+    {
+        M_BenchStart(demolumpname);
+        G_TimeDemo(demolumpname);
+        D_DoomLoop();           // Never returns
+    }
+
     //!
     // @arg <s>
     // @vanilla
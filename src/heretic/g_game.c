@@ -29,6 +29,7 @@
 #include "i_timer.h"
 #include "i_system.h"
 #include "m_argv.h"
+#include "m_bench.h"
 #include "m_controls.h"
 #include "m_misc.h"
 #include "m_random.h"
@@ -1287,7 +1288,9 @@ void G_Ticker(void)
     switch (gamestate)
     {
         case GS_LEVEL:
+            M_BenchBegin(bench_ticker);
             P_Ticker();
+            M_BenchEnd(bench_ticker);
             SB_Ticker();
             AM_Ticker();
             CT_Ticker();
@@ -2283,7 +2286,10 @@ boolean G_CheckDemoStatus(void)
         endtime = I_GetTime();
         realtics = endtime - starttime;
         fps = ((float) gametic * TICRATE) / realtics;
-        
+
+        // [JN] -benchmark report goes before the summary below.
+        M_BenchReport();
+
         if (english_language)
         {
             I_Error("timed %i gametics in %i realtics (%f fps)",
@@ -191,6 +191,7 @@ typedef struct
 
 #define	MAXINTERCEPTS	128*16 // [JN] Multiplied by 16
 extern intercept_t intercepts[MAXINTERCEPTS], *intercept_p;
+extern int tracecount;           // [JN] bumped when intercepts are refilled
 typedef boolean(*traverser_t) (intercept_t * in);
 
 
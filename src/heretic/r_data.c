@@ -754,6 +754,27 @@ int R_TextureNumForName(char *name)
 }
 
 
+//
+// R_PrecacheLump
+// Queues a lump for R_PrecacheLevel, which loads them all in one go
+// with W_CacheLumps.
+//
+
+static lumpindex_t *precachelumps;
+static int numprecachelumps, maxprecachelumps;
+
+static void R_PrecacheLump(int lump)
+{
+    if (numprecachelumps == maxprecachelumps)
+    {
+        maxprecachelumps = maxprecachelumps ? maxprecachelumps * 2 : 512;
+        precachelumps = I_Realloc(precachelumps,
+                                  maxprecachelumps * sizeof(*precachelumps));
+    }
+
+    precachelumps[numprecachelumps++] = lump;
+}
+
 /*
 =================
 =
@@ -795,7 +816,7 @@ void R_PrecacheLevel(void)
         {
             lump = firstflat + i;
             flatmemory += lumpinfo[lump]->size;
-            W_CacheLumpNum(lump, PU_CACHE);
+            R_PrecacheLump(lump);
         }
 
     Z_Free(flatpresent);
@@ -825,7 +846,7 @@ void R_PrecacheLevel(void)
         {
             lump = texture->patches[j].patch;
             texturememory += lumpinfo[lump]->size;
-            W_CacheLumpNum(lump, PU_CACHE);
+            R_PrecacheLump(lump);
         }
     }
 
@@ -855,10 +876,14 @@ void R_PrecacheLevel(void)
             {
                 lump = firstspritelump + sf->lump[k];
                 spritememory += lumpinfo[lump]->size;
-                W_CacheLumpNum(lump, PU_CACHE);
+                R_PrecacheLump(lump);
             }
         }
     }
 
     Z_Free(spritepresent);
+
+    // Read everything in file order
+    W_CacheLumps(precachelumps, numprecachelumps, PU_CACHE);
+    numprecachelumps = 0;
 }
@@ -20,9 +20,11 @@
 
 #include "doomdef.h"
 #include "deh_str.h"
+#include "i_simd.h"
 #include "r_local.h"
 #include "i_video.h"
 #include "v_video.h"
+#include "jn.h"
 
 /*
 
@@ -412,6 +414,15 @@ void R_DrawSpan(void)
                 ds_x1, ds_x2, ds_y);
 #endif
 
+    // [JN] Unflipped spans cover consecutive screen pixels,
+    // so they can go through the vectorized kernel.
+    if (!flip_levels)
+    {
+        I_DrawSpanRow(ylookup[ds_y] + columnofs[ds_x1], ds_source, ds_colormap,
+                      ds_xfrac, ds_yfrac, ds_xstep, ds_ystep, ds_x2 - ds_x1 + 1);
+        return;
+    }
+
     xfrac = ds_xfrac;
     yfrac = ds_yfrac;
 
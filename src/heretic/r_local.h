@@ -215,6 +215,7 @@ typedef struct
     int lightlevel;
     int special;
     int minx, maxx;
+    int next;                         // [JN] index of next visplane in hash chain
     unsigned int pad1;                // [crispy] hires / 32-bit integer math
     unsigned int top[WIDESCREENWIDTH];// [crispy] hires / 32-bit integer math
     unsigned int pad2;                // [crispy] hires / 32-bit integer math
@@ -265,6 +266,7 @@ typedef struct vissprite_s
 
 
 extern visplane_t *floorplane, *ceilingplane;
+extern int rendered_visplanes; // [JN] Visplanes used in last frame
 
 // Sprites are patches with a special naming convention so they can be 
 // recognized by R_InitSprites.  The sprite and frame specified by a 
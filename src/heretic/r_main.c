@@ -22,7 +22,9 @@
 #include <math.h>
 #include "doomdef.h"
 #include "m_bbox.h"
+#include "m_bench.h"
 #include "r_local.h"
+#include "i_simd.h"
 #include "p_local.h"
 #include "tables.h"
 #include "i_timer.h"
@@ -801,6 +803,7 @@ void R_Init(void)
     R_InitSkyMap();
     printf (".");
     R_InitTranslationTables();
+    I_InitSIMD();
 
     framecount = 0;
 }
@@ -997,10 +1000,16 @@ void R_RenderPlayerView(player_t * player)
     R_ClearSprites();
     NetUpdate();                // check for new console commands
     R_InterpolateTextureOffsets();      // [crispy] smooth texture scrolling
+    M_BenchBegin(bench_bsp);
     R_RenderBSPNode(numnodes - 1);      // the head node is the last node output
+    M_BenchEnd(bench_bsp);
     NetUpdate();                // check for new console commands
+    M_BenchBegin(bench_planes);
     R_DrawPlanes();
+    M_BenchEnd(bench_planes);
     NetUpdate();                // check for new console commands
+    M_BenchBegin(bench_masked);
     R_DrawMasked();
+    M_BenchEnd(bench_masked);
     NetUpdate();                // check for new console commands
 }
@@ -668,6 +668,14 @@ void SB_Drawer(void)
         MN_DrTextC(fps, 297 + (wide_4_3 ? wide_delta : wide_delta*2), 23);   // [JN] fps digits
     }
 
+    // [JN] Draw visplane counter along with FPS dots
+    if (DisplayTicker)
+    {
+        sprintf (fps, "%d", rendered_visplanes);
+        MN_DrTextC("VP:", 279 + (wide_4_3 ? wide_delta : wide_delta*2), 33);
+        MN_DrTextC(fps, 297 + (wide_4_3 ? wide_delta : wide_delta*2), 33);
+    }
+
     // Sound info debug stuff
     if (DebugSound == true)
     {
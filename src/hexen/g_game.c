@@ -27,6 +27,7 @@
 #include "i_system.h"
 #include "i_timer.h"
 #include "m_argv.h"
+#include "m_bench.h"
 #include "m_controls.h"
 #include "m_misc.h"
 #include "p_local.h"
@@ -1295,7 +1296,9 @@ void G_Ticker(void)
     switch (gamestate)
     {
         case GS_LEVEL:
+            M_BenchBegin(bench_ticker);
             P_Ticker();
+            M_BenchEnd(bench_ticker);
             SB_Ticker();
             AM_Ticker();
             CT_Ticker();
@@ -2411,6 +2414,10 @@ boolean G_CheckDemoStatus(void)
         endtime = I_GetTime();
         realtics = endtime - starttime;
         fps = ((float) gametic * TICRATE) / realtics;
+
+        // [JN] -benchmark report goes before the summary below.
+        M_BenchReport();
+
         I_Error (english_language ?
                  "Timed %i gametics in %i realtics (%f fps)" :
                  "Насчитано %i gametics в %i realtics.\n Среднее значение FPS: %f.",
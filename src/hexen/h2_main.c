@@ -45,6 +45,7 @@
 #include "i_system.h"
 #include "i_timer.h"
 #include "m_argv.h"
+#include "m_bench.h"
 #include "m_config.h"
 #include "m_controls.h"
 #include "net_client.h"
@@ -738,6 +739,14 @@ void D_DoomMain(void)
         H2_GameLoop();          // Never returns
     }
 
+    p = M_CheckParmWithArgs("-benchmark", 1);
+    if (p)
+    {
+        M_BenchStart(demolumpname);
+        G_TimeDemo(demolumpname);
+        H2_GameLoop();          // Never returns
+    }
+
     //!
     // @arg <s>
     // @vanilla
@@ -910,6 +919,20 @@ static void HandleArgs(void)
         p = M_CheckParmWithArgs("-timedemo", 1);
     }
 
+    if (!p)
+    {
+        //!
+        // @arg <demo>
+        // @category demo
+        //
+        // Play back the demo named demo.lmp as -timedemo does, timing
+        // the game and renderer phases of every frame. Prints min,
+        // median, 99th percentile and max of each phase; see -benchout.
+        //
+
+        p = M_CheckParmWithArgs("-benchmark", 1);
+    }
+
     if (p)
     {
         char *uc_filename;
@@ -1031,11 +1054,16 @@ void H2_GameLoop(void)
         TryRunTics();
 
         // Move positional sounds
+        M_BenchBegin(bench_sound);
         S_UpdateSounds(players[displayplayer].mo);
+        M_BenchEnd(bench_sound);
 
         // Update display, next frame, with current state.
         if (screenvisible)
         DrawAndBlit();
+
+        // [JN] Close per-phase timings of -benchmark.
+        M_BenchFrame();
     }
 }
 
@@ -1157,7 +1185,9 @@ static void DrawAndBlit(void)
     NetUpdate();
 
     // Flush buffered stuff to screen
+    M_BenchBegin(bench_finishupdate);
     I_FinishUpdate();
+    M_BenchEnd(bench_finishupdate);
 }
 
 //==========================================================================
@@ -206,6 +206,7 @@ typedef struct
 
 #define MAXINTERCEPTS   128
 extern intercept_t intercepts[MAXINTERCEPTS], *intercept_p;
+extern int tracecount;           // [JN] bumped when intercepts are refilled
 typedef boolean(*traverser_t) (intercept_t * in);
 
 
@@ -630,6 +630,62 @@ boolean PIT_AddThingIntercepts(mobj_t * thing)
 }
 
 
+// [JN] Intercepts are visited nearest first, equal distances in the
+// order they were added, which is what the original rescan of the
+// whole array for every intercept gives. A binary heap pops them in
+// the same order, so long traces that stop at the first wall don't pay
+// for a scan per intercept.
+//
+// tracecount changes whenever the intercepts array is refilled. A
+// traverser may start another trace from an action function, after
+// which the scan of the new contents is kept. The array isn't bounds
+// checked here, overflowed traces are scanned as well.
+
+int tracecount;
+
+static intercept_t *interceptheap[MAXINTERCEPTS + 1];
+static int heapsize;
+
+static inline boolean P_InterceptBefore(intercept_t *a, intercept_t *b)
+{
+    return a->frac < b->frac || (a->frac == b->frac && a < b);
+}
+
+static void P_SiftIntercept(int i)
+{
+    intercept_t *in = interceptheap[i];
+    int child;
+
+    while ((child = 2 * i + 1) < heapsize)
+    {
+        if (child + 1 < heapsize
+         && P_InterceptBefore(interceptheap[child + 1], interceptheap[child]))
+            child++;
+
+        if (!P_InterceptBefore(interceptheap[child], in))
+            break;
+
+        interceptheap[i] = interceptheap[child];
+        i = child;
+    }
+
+    interceptheap[i] = in;
+}
+
+static intercept_t *P_NextIntercept(void)
+{
+    intercept_t *in = interceptheap[0];
+
+    if (--heapsize > 0)
+    {
+        interceptheap[0] = interceptheap[heapsize];
+        P_SiftIntercept(0);
+    }
+
+    return in;
+}
+
+
 /*
 ====================
 =
@@ -642,21 +698,45 @@ boolean PIT_AddThingIntercepts(mobj_t * thing)
 boolean P_TraverseIntercepts(traverser_t func, fixed_t maxfrac)
 {
     int count;
+    int trace;
     fixed_t dist;
     intercept_t *scan, *in;
 
     count = intercept_p - intercepts;
+    trace = tracecount;
     in = 0;                     // shut up compiler warning
 
+    if (count > MAXINTERCEPTS + 1)
+    {
+        // more than the heap holds, scan them instead
+        trace--;
+    }
+    else
+    {
+        for (heapsize = 0; heapsize < count; heapsize++)
+            interceptheap[heapsize] = &intercepts[heapsize];
+
+        for (scan = intercepts + count / 2; scan-- > intercepts;)
+            P_SiftIntercept(scan - intercepts);
+    }
+
     while (count--)
     {
-        dist = INT_MAX;
-        for (scan = intercepts; scan < intercept_p; scan++)
-            if (scan->frac < dist)
-            {
-                dist = scan->frac;
-                in = scan;
-            }
+        if (trace == tracecount)
+        {
+            in = P_NextIntercept();
+            dist = in->frac;
+        }
+        else
+        {
+            dist = INT_MAX;
+            for (scan = intercepts; scan < intercept_p; scan++)
+                if (scan->frac < dist)
+                {
+                    dist = scan->frac;
+                    in = scan;
+                }
+        }
 
         if (dist > maxfrac)
             return true;        // checked everything in range
@@ -704,6 +784,7 @@ boolean P_PathTraverse(fixed_t x1, fixed_t y1, fixed_t x2, fixed_t y2,
     earlyout = (flags & PT_EARLYOUT) != 0;
 
     validcount++;
+    tracecount++;
     intercept_p = intercepts;
 
     if (((x1 - bmaporgx) & (MAPBLOCKSIZE - 1)) == 0)
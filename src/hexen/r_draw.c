@@ -18,10 +18,12 @@
 
 
 #include "h2def.h"
+#include "i_simd.h"
 #include "i_system.h"
 #include "i_video.h"
 #include "r_local.h"
 #include "v_video.h"
+#include "jn.h"
 
 /*
 
@@ -439,6 +441,15 @@ void R_DrawSpan(void)
 //      dscount++;
 #endif
 
+    // [JN] Unflipped spans cover consecutive screen pixels,
+    // so they can go through the vectorized kernel.
+    if (!flip_levels)
+    {
+        I_DrawSpanRow(ylookup[ds_y] + columnofs[ds_x1], ds_source, ds_colormap,
+                      ds_xfrac, ds_yfrac, ds_xstep, ds_ystep, ds_x2 - ds_x1 + 1);
+        return;
+    }
+
     xfrac = ds_xfrac;
     yfrac = ds_yfrac;
 
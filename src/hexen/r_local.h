@@ -249,6 +249,7 @@ typedef struct
     int lightlevel;
     int special;
     int minx, maxx;
+    int next;                         // [JN] index of next visplane in hash chain
     unsigned short pad1;                  // leave pads for [minx-1]/[maxx+1]
     unsigned short top[WIDESCREENWIDTH];
     unsigned short pad2;
@@ -299,6 +300,7 @@ typedef struct vissprite_s
 
 
 extern visplane_t *floorplane, *ceilingplane;
+extern int rendered_visplanes; // [JN] Visplanes used in last frame
 
 // Sprites are patches with a special naming convention so they can be
 // recognized by R_InitSprites.  The sprite and frame specified by a
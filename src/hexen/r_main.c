@@ -21,7 +21,9 @@
 #include "m_random.h"
 #include "h2def.h"
 #include "m_bbox.h"
+#include "m_bench.h"
 #include "r_local.h"
+#include "i_simd.h"
 #include "p_local.h"
 #include "i_timer.h"
 #include "crispy.h"
@@ -778,6 +780,7 @@ void R_Init(void)
     R_InitLightTables();
     R_InitSkyMap();
     R_InitTranslationTables();
+    I_InitSIMD();
 
     framecount = 0;
 }
@@ -969,6 +972,8 @@ void R_RenderPlayerView(player_t * player)
     R_ClearSprites();
     NetUpdate();                // check for new console commands
 
+    M_BenchBegin(bench_bsp);
+
     // Make displayed player invisible locally
     if (localQuakeHappening[displayplayer] && gamestate == GS_LEVEL)
     {
@@ -981,9 +986,15 @@ void R_RenderPlayerView(player_t * player)
         R_RenderBSPNode(numnodes - 1);  // head node is the last node output
     }
 
+    M_BenchEnd(bench_bsp);
+
     NetUpdate();                // check for new console commands
+    M_BenchBegin(bench_planes);
     R_DrawPlanes();
+    M_BenchEnd(bench_planes);
     NetUpdate();                // check for new console commands
+    M_BenchBegin(bench_masked);
     R_DrawMasked();
+    M_BenchEnd(bench_masked);
     NetUpdate();                // check for new console commands
 }
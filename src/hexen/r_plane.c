@@ -55,6 +55,17 @@ visplane_t *visplanes = NULL;
 visplane_t *lastvisplane;
 visplane_t *floorplane, *ceilingplane;
 static int numvisplanes;
+
+// [JN] Hash index over visplanes, keyed on (height, picnum, lightlevel,
+// special). Only the first visplane of every key is linked in, so
+// R_FindPlane returns exactly the same plane as the old linear search.
+// Chains hold array indices, as R_RaiseVisplanes may move the array.
+#define VISPLANEHASHSIZE 512
+#define visplane_hash(picnum,lightlevel,height) \
+    (((unsigned int)(picnum)*3+(unsigned int)(lightlevel)+(unsigned int)(height)*7) & (VISPLANEHASHSIZE-1))
+static int visplanehash[VISPLANEHASHSIZE];
+
+int rendered_visplanes; // [JN] Visplanes used in last frame
 short openings[MAXOPENINGS], *lastopening;
 
 // Clip values are the solid pixel bounding the range.
@@ -234,6 +245,9 @@ void R_ClearPlanes(void)
     lastvisplane = visplanes;
     lastopening = openings;
 
+    // [JN] Empty the visplane hash
+    memset(visplanehash, -1, sizeof(visplanehash));
+
     // Texture calculation
     memset(cachedheight, 0, sizeof(cachedheight));
     angle = (viewangle - ANG90) >> ANGLETOFINESHIFT;    // left to right mapping
@@ -277,6 +291,8 @@ visplane_t *R_FindPlane(fixed_t height, int picnum,
                         int lightlevel, int special)
 {
     visplane_t *check;
+    int i;
+    unsigned int hash;
 
     if (special < 150)
     {                           // Don't let low specials affect search
@@ -289,19 +305,21 @@ visplane_t *R_FindPlane(fixed_t height, int picnum,
         lightlevel = 0;
     }
 
-    for (check = visplanes; check < lastvisplane; check++)
+    hash = visplane_hash(picnum, lightlevel, height);
+
+    for (i = visplanehash[hash]; i != -1; i = check->next)
     {
+        check = visplanes + i;
+
         if (height == check->height
             && picnum == check->picnum
             && lightlevel == check->lightlevel && special == check->special)
-            break;
-    }
-
-    if (check < lastvisplane)
-    {
-        return (check);
+        {
+            return (check);
+        }
     }
 
+    check = lastvisplane;
     R_RaiseVisplanes(&check);
 
     lastvisplane++;
@@ -311,6 +329,8 @@ visplane_t *R_FindPlane(fixed_t height, int picnum,
     check->special = special;
     check->minx = screenwidth;
     check->maxx = -1;
+    check->next = visplanehash[hash];   // [JN] link new key into the hash
+    visplanehash[hash] = check - visplanes;
     memset(check->top, 0xff, sizeof(check->top));
     return (check);
 }
@@ -461,6 +481,8 @@ void R_DrawPlanes(void)
     }
 #endif
 
+    rendered_visplanes = lastvisplane - visplanes;
+
     for (pl = visplanes; pl < lastvisplane; pl++)
     {
         if (pl->minx > pl->maxx)
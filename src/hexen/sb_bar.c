@@ -791,6 +791,13 @@ void SB_Drawer(void)
         MN_DrTextC(s, 294 + (wide_4_3 ? wide_delta : wide_delta*2), 19);
     }
 
+    // [JN] Draw visplane counter along with FPS dots
+    if (DisplayTicker)
+    {
+        M_snprintf(s, sizeof(s), "VP: %d", rendered_visplanes);
+        MN_DrTextC(s, 279 + (wide_4_3 ? wide_delta : wide_delta*2), 29);
+    }
+
     // Sound info debug stuff
     if (DebugSound == true)
     {
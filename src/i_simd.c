@@ -0,0 +1,377 @@
+//
+// Copyright(C) 2016-2019 Julian Nechaevsky
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// DESCRIPTION:
+//      Vectorized drawing kernels, picked at startup by CPU features.
+//
+//      x86 kernels are built with per-function target attributes, so
+//      the rest of the program does not need -mavx2 and still runs on
+//      CPUs without it. The scalar kernel is always available and is
+//      the reference the others are checked against with -simdcheck.
+//
+
+
+
+#include <stdio.h>
+#include <string.h>
+
+#include "SDL.h"
+
+#include "i_simd.h"
+#include "i_system.h"
+#include "m_argv.h"
+#include "jn.h"
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#define SIMD_X86
+#include <immintrin.h>
+#if defined(__GNUC__) || defined(__clang__)
+#define SIMD_TARGET(x) __attribute__((target(x)))
+#else
+#define SIMD_TARGET(x)
+#endif
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define SIMD_NEON
+#include <arm_neon.h>
+#endif
+
+
+spanrow_t I_DrawSpanRow;
+
+static spanrow_t simd_kernel;
+static const char *simd_name;
+
+
+//
+// Plain C version. Texture index is y in bits 6-11, x in bits 0-5,
+// both taken from the integer part of the 16.16 coordinates.
+//
+
+static void DrawSpanRowScalar(byte *dest, const byte *source, const byte *colormap,
+                              unsigned int xfrac, unsigned int yfrac,
+                              unsigned int xstep, unsigned int ystep, int count)
+{
+    while (count-- > 0)
+    {
+        *dest++ = colormap[source[((yfrac >> 10) & 0xfc0) | ((xfrac >> 16) & 0x3f)]];
+        xfrac += xstep;
+        yfrac += ystep;
+    }
+}
+
+#ifdef SIMD_X86
+
+//
+// SSE2 has no gathers: texture indexes for 16 pixels are computed
+// four at a time, looked up one by one and stored with one write.
+//
+
+SIMD_TARGET("sse2")
+static void DrawSpanRowSSE2(byte *dest, const byte *source, const byte *colormap,
+                            unsigned int xfrac, unsigned int yfrac,
+                            unsigned int xstep, unsigned int ystep, int count)
+{
+    const __m128i xmask = _mm_set1_epi32(0x3f);
+    const __m128i ymask = _mm_set1_epi32(0xfc0);
+    const __m128i xstep4 = _mm_set1_epi32((int) (xstep * 4));
+    const __m128i ystep4 = _mm_set1_epi32((int) (ystep * 4));
+    __m128i xf, yf, spot;
+    int spots[16];
+    byte pixels[16];
+    int i;
+
+    xf = _mm_setr_epi32((int) xfrac, (int) (xfrac + xstep),
+                        (int) (xfrac + xstep * 2), (int) (xfrac + xstep * 3));
+    yf = _mm_setr_epi32((int) yfrac, (int) (yfrac + ystep),
+                        (int) (yfrac + ystep * 2), (int) (yfrac + ystep * 3));
+
+    while (count >= 16)
+    {
+        for (i = 0; i < 16; i += 4)
+        {
+            spot = _mm_or_si128(_mm_and_si128(_mm_srli_epi32(yf, 10), ymask),
+                                _mm_and_si128(_mm_srli_epi32(xf, 16), xmask));
+            _mm_storeu_si128((__m128i *) &spots[i], spot);
+            xf = _mm_add_epi32(xf, xstep4);
+            yf = _mm_add_epi32(yf, ystep4);
+        }
+
+        for (i = 0; i < 16; i++)
+        {
+            pixels[i] = colormap[source[spots[i]]];
+        }
+
+        _mm_storeu_si128((__m128i *) dest, _mm_loadu_si128((const __m128i *) pixels));
+        dest += 16;
+        count -= 16;
+    }
+
+    DrawSpanRowScalar(dest, source, colormap,
+                      (unsigned int) _mm_cvtsi128_si32(xf),
+                      (unsigned int) _mm_cvtsi128_si32(yf),
+                      xstep, ystep, count);
+}
+
+//
+// Loads eight bytes from table[index] with one gather. The gather
+// reads the aligned dword holding each byte: an aligned dword never
+// crosses a page, so it can not fault where the byte load would not.
+//
+
+SIMD_TARGET("avx2")
+static inline __m256i GatherBytesAVX2(const int *words, __m256i align, __m256i index)
+{
+    __m256i offset, value;
+
+    offset = _mm256_add_epi32(index, align);
+    value = _mm256_i32gather_epi32(words, _mm256_srli_epi32(offset, 2), 4);
+    value = _mm256_srlv_epi32(value, _mm256_slli_epi32(
+                              _mm256_and_si256(offset, _mm256_set1_epi32(3)), 3));
+
+    return _mm256_and_si256(value, _mm256_set1_epi32(0xff));
+}
+
+SIMD_TARGET("avx2")
+static void DrawSpanRowAVX2(byte *dest, const byte *source, const byte *colormap,
+                            unsigned int xfrac, unsigned int yfrac,
+                            unsigned int xstep, unsigned int ystep, int count)
+{
+    const int *srcwords = (const int *) ((uintptr_t) source & ~(uintptr_t) 3);
+    const int *cmwords = (const int *) ((uintptr_t) colormap & ~(uintptr_t) 3);
+    const __m256i srcalign = _mm256_set1_epi32((int) ((uintptr_t) source & 3));
+    const __m256i cmalign = _mm256_set1_epi32((int) ((uintptr_t) colormap & 3));
+    const __m256i xmask = _mm256_set1_epi32(0x3f);
+    const __m256i ymask = _mm256_set1_epi32(0xfc0);
+    const __m256i xstep8 = _mm256_set1_epi32((int) (xstep * 8));
+    const __m256i ystep8 = _mm256_set1_epi32((int) (ystep * 8));
+    const __m256i lanes = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+    const __m256i order = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+    __m256i xf, yf, spot, lo, hi;
+
+    xf = _mm256_add_epi32(_mm256_set1_epi32((int) xfrac),
+                          _mm256_mullo_epi32(_mm256_set1_epi32((int) xstep), lanes));
+    yf = _mm256_add_epi32(_mm256_set1_epi32((int) yfrac),
+                          _mm256_mullo_epi32(_mm256_set1_epi32((int) ystep), lanes));
+
+    while (count >= 16)
+    {
+        spot = _mm256_or_si256(_mm256_and_si256(_mm256_srli_epi32(yf, 10), ymask),
+                               _mm256_and_si256(_mm256_srli_epi32(xf, 16), xmask));
+        lo = GatherBytesAVX2(cmwords, cmalign, GatherBytesAVX2(srcwords, srcalign, spot));
+        xf = _mm256_add_epi32(xf, xstep8);
+        yf = _mm256_add_epi32(yf, ystep8);
+
+        spot = _mm256_or_si256(_mm256_and_si256(_mm256_srli_epi32(yf, 10), ymask),
+                               _mm256_and_si256(_mm256_srli_epi32(xf, 16), xmask));
+        hi = GatherBytesAVX2(cmwords, cmalign, GatherBytesAVX2(srcwords, srcalign, spot));
+        xf = _mm256_add_epi32(xf, xstep8);
+        yf = _mm256_add_epi32(yf, ystep8);
+
+        // Narrow 2x8 dwords to 16 bytes. Packs work per 128-bit lane,
+        // so the dwords holding four pixels each are put back in order.
+        lo = _mm256_packus_epi32(lo, hi);
+        lo = _mm256_packus_epi16(lo, lo);
+        lo = _mm256_permutevar8x32_epi32(lo, order);
+
+        _mm_storeu_si128((__m128i *) dest, _mm256_castsi256_si128(lo));
+        dest += 16;
+        count -= 16;
+    }
+
+    DrawSpanRowScalar(dest, source, colormap,
+                      (unsigned int) _mm_cvtsi128_si32(_mm256_castsi256_si128(xf)),
+                      (unsigned int) _mm_cvtsi128_si32(_mm256_castsi256_si128(yf)),
+                      xstep, ystep, count);
+}
+
+#endif // SIMD_X86
+
+#ifdef SIMD_NEON
+
+//
+// Same as the SSE2 kernel. NEON has no gathers either.
+//
+
+static void DrawSpanRowNEON(byte *dest, const byte *source, const byte *colormap,
+                            unsigned int xfrac, unsigned int yfrac,
+                            unsigned int xstep, unsigned int ystep, int count)
+{
+    const uint32x4_t xmask = vdupq_n_u32(0x3f);
+    const uint32x4_t ymask = vdupq_n_u32(0xfc0);
+    const uint32x4_t xstep4 = vdupq_n_u32(xstep * 4);
+    const uint32x4_t ystep4 = vdupq_n_u32(ystep * 4);
+    uint32x4_t xf, yf, spot;
+    uint32_t start[4];
+    uint32_t spots[16];
+    byte pixels[16];
+    int i;
+
+    for (i = 0; i < 4; i++)
+    {
+        start[i] = xfrac + xstep * i;
+    }
+    xf = vld1q_u32(start);
+
+    for (i = 0; i < 4; i++)
+    {
+        start[i] = yfrac + ystep * i;
+    }
+    yf = vld1q_u32(start);
+
+    while (count >= 16)
+    {
+        for (i = 0; i < 16; i += 4)
+        {
+            spot = vorrq_u32(vandq_u32(vshrq_n_u32(yf, 10), ymask),
+                             vandq_u32(vshrq_n_u32(xf, 16), xmask));
+            vst1q_u32(&spots[i], spot);
+            xf = vaddq_u32(xf, xstep4);
+            yf = vaddq_u32(yf, ystep4);
+        }
+
+        for (i = 0; i < 16; i++)
+        {
+            pixels[i] = colormap[source[spots[i]]];
+        }
+
+        vst1q_u8(dest, vld1q_u8(pixels));
+        dest += 16;
+        count -= 16;
+    }
+
+    DrawSpanRowScalar(dest, source, colormap,
+                      vgetq_lane_u32(xf, 0), vgetq_lane_u32(yf, 0),
+                      xstep, ystep, count);
+}
+
+#endif // SIMD_NEON
+
+//
+// -simdcheck: draw with the selected kernel, then compare every pixel
+// against the scalar kernel. Spans may be drawn by render threads, so
+// the first mismatch is only recorded here and I_CheckSIMD reports it
+// from the main thread.
+//
+
+static SDL_atomic_t simd_mismatch;
+static unsigned int mismatch_xfrac, mismatch_yfrac;
+static unsigned int mismatch_xstep, mismatch_ystep;
+
+static void DrawSpanRowChecked(byte *dest, const byte *source, const byte *colormap,
+                               unsigned int xfrac, unsigned int yfrac,
+                               unsigned int xstep, unsigned int ystep, int count)
+{
+    byte check[64];
+    int n;
+
+    simd_kernel(dest, source, colormap, xfrac, yfrac, xstep, ystep, count);
+
+    while (count > 0)
+    {
+        n = count < 64 ? count : 64;
+
+        DrawSpanRowScalar(check, source, colormap, xfrac, yfrac, xstep, ystep, n);
+
+        if (memcmp(check, dest, n))
+        {
+            if (SDL_AtomicCAS(&simd_mismatch, 0, 1))
+            {
+                mismatch_xfrac = xfrac;
+                mismatch_yfrac = yfrac;
+                mismatch_xstep = xstep;
+                mismatch_ystep = ystep;
+            }
+
+            return;
+        }
+
+        dest += n;
+        xfrac += xstep * n;
+        yfrac += ystep * n;
+        count -= n;
+    }
+}
+
+void I_InitSIMD(void)
+{
+    simd_kernel = DrawSpanRowScalar;
+    simd_name = "scalar";
+
+    //!
+    // @category video
+    //
+    // Don't use vectorized (SSE2, AVX2, NEON) drawing kernels.
+    //
+
+    if (!M_ParmExists("-nosimd"))
+    {
+#ifdef SIMD_X86
+#if SDL_VERSION_ATLEAST(2, 0, 2)
+        if (SDL_HasAVX2())
+        {
+            simd_kernel = DrawSpanRowAVX2;
+            simd_name = "AVX2";
+        }
+        else
+#endif
+        if (SDL_HasSSE2())
+        {
+            simd_kernel = DrawSpanRowSSE2;
+            simd_name = "SSE2";
+        }
+#endif
+#ifdef SIMD_NEON
+        // Built for NEON means the compiler may use it anywhere anyway.
+        simd_kernel = DrawSpanRowNEON;
+        simd_name = "NEON";
+#endif
+    }
+
+    //!
+    // @category video
+    //
+    // Check every span drawn by a vectorized kernel against the plain
+    // C one, and quit with an error on the first pixel that differs.
+    //
+
+    if (M_ParmExists("-simdcheck") && simd_kernel != DrawSpanRowScalar)
+    {
+        I_DrawSpanRow = DrawSpanRowChecked;
+    }
+    else
+    {
+        I_DrawSpanRow = simd_kernel;
+    }
+}
+
+void I_CheckSIMD(void)
+{
+    // Render threads are idle once I_RunParallel has returned, and
+    // SDL_AtomicGet needs SDL 2.0.2.
+    if (simd_mismatch.value)
+    {
+        I_Error(english_language ?
+                "I_DrawSpanRow: %s kernel does not match scalar kernel "
+                "(frac %08x %08x, step %08x %08x)" :
+                "I_DrawSpanRow: ядро %s не совпадает со скалярным "
+                "(frac %08x %08x, step %08x %08x)",
+                simd_name, mismatch_xfrac, mismatch_yfrac,
+                mismatch_xstep, mismatch_ystep);
+    }
+}
+
+const char *I_SIMDName(void)
+{
+    return simd_name;
+}
+
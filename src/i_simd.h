@@ -0,0 +1,43 @@
+//
+// Copyright(C) 2016-2019 Julian Nechaevsky
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// DESCRIPTION:
+//      Vectorized drawing kernels, picked at startup by CPU features.
+//
+
+
+#ifndef __I_SIMD__
+#define __I_SIMD__
+
+#include "doomtype.h"
+
+// Draws count pixels of a span through a 64*64 flat into a row of
+// consecutive screen pixels. Same texel stepping as R_DrawSpan.
+typedef void (*spanrow_t)(byte *dest, const byte *source, const byte *colormap,
+                          unsigned int xfrac, unsigned int yfrac,
+                          unsigned int xstep, unsigned int ystep, int count);
+
+extern spanrow_t I_DrawSpanRow;
+
+// Picks the best kernel for this CPU. Safe to call more than once.
+void I_InitSIMD(void);
+
+// With -simdcheck, quits with an error if a span drawn since startup
+// did not match the scalar kernel. Main thread only.
+void I_CheckSIMD(void);
+
+// Name of the selected span kernel, for startup messages.
+const char *I_SIMDName(void);
+
+#endif
+
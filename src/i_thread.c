@@ -0,0 +1,177 @@
+//
+// Copyright(C) 2016-2019 Julian Nechaevsky
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// DESCRIPTION:
+//      Worker thread pool.
+//
+//      Workers sleep on a semaphore until I_RunParallel hands out a
+//      batch. Indexes are taken from a shared atomic counter, and the
+//      calling thread works on the batch too until it runs dry. Index 0
+//      is never handed out, the calling thread runs it first.
+//
+
+
+
+#include <stdio.h>
+
+#include "SDL.h"
+
+#include "i_system.h"
+#include "i_thread.h"
+
+
+static SDL_Thread *workers[MAXTHREADS];
+static int num_workers = 0;
+
+static SDL_sem *job_start;
+static SDL_sem *job_done;
+static boolean job_quit;
+
+static threadjob_t job_func;
+static void *job_data;
+static int job_count;
+static SDL_atomic_t job_next;
+
+
+static void RunJobs(void)
+{
+    int i;
+
+    while ((i = SDL_AtomicAdd(&job_next, 1)) < job_count)
+    {
+        job_func(job_data, i);
+    }
+}
+
+static int WorkerLoop(void *unused)
+{
+    for (;;)
+    {
+        SDL_SemWait(job_start);
+
+        if (job_quit)
+        {
+            break;
+        }
+
+        RunJobs();
+        SDL_SemPost(job_done);
+    }
+
+    return 0;
+}
+
+static void I_ShutdownThreads(void)
+{
+    int i;
+
+    job_quit = true;
+
+    for (i = 0; i < num_workers; i++)
+    {
+        SDL_SemPost(job_start);
+    }
+
+    for (i = 0; i < num_workers; i++)
+    {
+        SDL_WaitThread(workers[i], NULL);
+    }
+
+    num_workers = 0;
+
+    SDL_DestroySemaphore(job_start);
+    SDL_DestroySemaphore(job_done);
+}
+
+void I_InitThreads(int numthreads)
+{
+    if (num_workers > 0)
+    {
+        return;
+    }
+
+    if (numthreads > MAXTHREADS)
+    {
+        numthreads = MAXTHREADS;
+    }
+
+    if (numthreads < 2)
+    {
+        return;
+    }
+
+    job_start = SDL_CreateSemaphore(0);
+    job_done = SDL_CreateSemaphore(0);
+
+    if (job_start == NULL || job_done == NULL)
+    {
+        printf("I_InitThreads: %s\n", SDL_GetError());
+        return;
+    }
+
+    while (num_workers < numthreads - 1)
+    {
+        workers[num_workers] = SDL_CreateThread(WorkerLoop, "worker", NULL);
+
+        if (workers[num_workers] == NULL)
+        {
+            printf("I_InitThreads: %s\n", SDL_GetError());
+            break;
+        }
+
+        num_workers++;
+    }
+
+    I_AtExit(I_ShutdownThreads, false);
+}
+
+int I_NumThreads(void)
+{
+    return num_workers + 1;
+}
+
+void I_RunParallel(threadjob_t job, void *data, int count)
+{
+    int i, wake;
+
+    if (num_workers == 0 || count < 2)
+    {
+        for (i = 0; i < count; i++)
+        {
+            job(data, i);
+        }
+
+        return;
+    }
+
+    job_func = job;
+    job_data = data;
+    job_count = count;
+    SDL_AtomicSet(&job_next, 1);
+
+    wake = count - 1 < num_workers ? count - 1 : num_workers;
+
+    for (i = 0; i < wake; i++)
+    {
+        SDL_SemPost(job_start);
+    }
+
+    // Index 0 is kept for the calling thread.
+    job(data, 0);
+    RunJobs();
+
+    for (i = 0; i < wake; i++)
+    {
+        SDL_SemWait(job_done);
+    }
+}
@@ -0,0 +1,49 @@
+//
+// Copyright(C) 2016-2019 Julian Nechaevsky
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// DESCRIPTION:
+//      Worker thread pool.
+//
+
+
+#ifndef __I_THREAD__
+#define __I_THREAD__
+
+#include "doomtype.h"
+
+// Most threads the pool will run, including the calling thread.
+#define MAXTHREADS 16
+
+// Storage class for state every thread needs its own copy of.
+#if defined(_MSC_VER)
+#define THREADLOCAL __declspec(thread)
+#else
+#define THREADLOCAL __thread
+#endif
+
+// A job is called once for every index in [0, count).
+typedef void (*threadjob_t)(void *data, int index);
+
+// Start numthreads-1 worker threads. The calling thread is
+// always counted as the first one.
+void I_InitThreads(int numthreads);
+
+// Number of threads that I_RunParallel spreads jobs over.
+int I_NumThreads(void);
+
+// Run job(data, 0) ... job(data, count-1) over the pool and wait
+// until all of them are done. job(data, 0) always runs on the calling
+// thread, so it may use the zone, the WAD cache and I_Error.
+void I_RunParallel(threadjob_t job, void *data, int count);
+
+#endif
@@ -61,6 +61,21 @@ int I_GetTimeMS(void)
     return ticks - basetime;
 }
 
+//
+// [JN] High resolution timer in microseconds, for profiling only.
+// Not related to the game time base above.
+//
+
+uint64_t I_GetTimeUS(void)
+{
+    Uint64 counter, freq;
+
+    counter = SDL_GetPerformanceCounter();
+    freq = SDL_GetPerformanceFrequency();
+
+    return (counter / freq) * 1000000 + (counter % freq) * 1000000 / freq;
+}
+
 // Sleep for a specified number of ms
 
 void I_Sleep(int ms)
@@ -38,14 +38,18 @@
 #include "doomtype.h"
 #include "i_input.h"
 #include "i_joystick.h"
+#include "i_simd.h"
 #include "i_system.h"
+#include "i_thread.h"
 #include "i_timer.h"
 #include "i_video.h"
 #include "m_argv.h"
+#include "m_bbox.h"
 #include "m_config.h"
 #include "m_misc.h"
 #include "tables.h"
 #include "v_diskicon.h"
+#include "v_trans.h"
 #include "v_video.h"
 #include "w_wad.h"
 #include "z_zone.h"
@@ -103,6 +107,42 @@ static uint32_t pixel_format;
 static SDL_Color palette[256];
 static boolean palette_to_set;
 
+// [JN] The same palette, already mapped to the pixel format of the
+// texture. I_FinishUpdate expands the 8-bit screen through it on
+// all render threads instead of calling SDL_LowerBlit.
+
+static uint32_t rgbapalette[256];
+
+// [JN] Inverse colour cube of the palette for I_GetPaletteIndex, made
+// again on the first lookup after the palette has changed.
+
+static palcube_t *palette_cube = NULL;
+static boolean palette_cube_stale = true;
+static boolean sdlblit = false;
+
+// [JN] Screen rows converted by one job of the palette expansion.
+
+#define BLITROWS 16
+
+typedef struct
+{
+    const byte *source;
+    int sourcepitch;
+    byte *dest;
+    int destpitch;
+    SDL_Rect rect;  // part of the screen to convert
+    int width;      // columns left of this are taken from the screen
+} blitjob_t;
+
+// [JN] The texture doesn't hold a complete frame yet, so the next
+// I_FinishUpdate has to convert all of the screen, dirty or not.
+
+static boolean fullblit = true;
+
+// [JN] Time spent converting and uploading the last frame, us.
+
+int rendered_blittime;
+
 // display has been set up?
 
 static boolean initialized = false;
@@ -690,15 +730,140 @@ static void CreateUpscaledTexture(boolean force)
 //      range of [0.0, 1.0).  Used for interpolation.
 fixed_t fractionaltic;
 
+//
+// ExpandRows
+// [JN] Converts BLITROWS rows of the 8-bit screen through rgbapalette.
+// Columns the screen doesn't cover are cleared, like the RGBA buffer
+// they replace.
+//
+static void ExpandRows (void *data, int index)
+{
+    const blitjob_t *job = data;
+    const byte *source;
+    uint32_t *dest;
+    int y, yend, x, w, count;
+
+    y = index * BLITROWS;
+    yend = y + BLITROWS;
+
+    if (yend > job->rect.h)
+    {
+        yend = job->rect.h;
+    }
+
+    // Columns of the texture right of the screen are cleared.
+    count = job->width - job->rect.x;
+
+    if (count > job->rect.w)
+    {
+        count = job->rect.w;
+    }
+
+    for ( ; y < yend ; y++)
+    {
+        source = job->source + (job->rect.y + y) * job->sourcepitch
+               + job->rect.x;
+        dest = (uint32_t *) (job->dest + y * job->destpitch);
+
+        for (x = 0 ; x + 4 <= count ; x += 4)
+        {
+            dest[x] = rgbapalette[source[x]];
+            dest[x + 1] = rgbapalette[source[x + 1]];
+            dest[x + 2] = rgbapalette[source[x + 2]];
+            dest[x + 3] = rgbapalette[source[x + 3]];
+        }
+
+        for ( ; x < count ; x++)
+        {
+            dest[x] = rgbapalette[source[x]];
+        }
+
+        for (w = job->rect.w ; x < w ; x++)
+        {
+            dest[x] = 0;
+        }
+    }
+}
+
+//
+// ExpandToTexture
+// [JN] Writes rect of the paletted screen into the locked streaming
+// texture. Returns false if the texture can't take it, so the caller
+// falls back to SDL_LowerBlit.
+//
+static boolean ExpandToTexture (const SDL_Rect *rect, int width)
+{
+    blitjob_t job;
+    void *pixels;
+    int pitch;
+
+    if (rgbabuffer->format->BytesPerPixel != 4)
+    {
+        return false;
+    }
+
+    if (SDL_LockTexture(texture, rect, &pixels, &pitch) != 0)
+    {
+        return false;
+    }
+
+    job.source = screenbuffer->pixels;
+    job.sourcepitch = screenbuffer->pitch;
+    job.dest = pixels;
+    job.destpitch = pitch;
+    job.rect = *rect;
+    job.width = width;
+
+    I_RunParallel(ExpandRows, &job, (rect->h + BLITROWS - 1) / BLITROWS);
+
+    SDL_UnlockTexture(texture);
+
+    return true;
+}
+
+//
+// GetDirtyRect
+// [JN] Clips the dirty box to the screen. Returns false if nothing
+// was drawn since the last frame.
+//
+static boolean GetDirtyRect (SDL_Rect *rect)
+{
+    int x1, y1, x2, y2;
+
+    x1 = dirtybox[BOXLEFT] > 0 ? dirtybox[BOXLEFT] : 0;
+    y1 = dirtybox[BOXBOTTOM] > 0 ? dirtybox[BOXBOTTOM] : 0;
+    x2 = dirtybox[BOXRIGHT] < screenwidth ? dirtybox[BOXRIGHT] : screenwidth - 1;
+    y2 = dirtybox[BOXTOP] < SCREENHEIGHT ? dirtybox[BOXTOP] : SCREENHEIGHT - 1;
+
+    if (x1 > x2 || y1 > y2)
+    {
+        return false;
+    }
+
+    rect->x = x1;
+    rect->y = y1;
+    rect->w = x2 - x1 + 1;
+    rect->h = y2 - y1 + 1;
+
+    return true;
+}
+
 //
 // I_FinishUpdate
 //
 void I_FinishUpdate (void)
 {
     static int lasttic;
+    SDL_Rect *blitrect;
+    SDL_Rect dirty, src;
+    uint64_t blitstart;
+    boolean update;
     int tics;
     int i;
 
+    // [JN] Report -simdcheck mismatches of the frame's render threads.
+    I_CheckSIMD();
+
     if (!initialized)
         return;
 
@@ -736,6 +901,8 @@ void I_FinishUpdate (void)
 	    I_VideoBuffer[ (SCREENHEIGHT-1)*screenwidth + i] = 0xff;
 	for ( ; i<20*4 ; i+=4)
 	    I_VideoBuffer[ (SCREENHEIGHT-1)*screenwidth + i] = 0x0;
+
+	V_MarkScreen(0, SCREENHEIGHT-1, 20*4, 1);
     }
 
 	// [crispy] [AM] Real FPS counter
@@ -767,9 +934,23 @@ void I_FinishUpdate (void)
     // Draw disk icon before blit, if necessary.
     V_DrawDiskIcon();
 
+    // [JN] A new palette changes every pixel of the texture.
+
+    if (!dirtyrects || palette_to_set)
+    {
+        fullblit = true;
+    }
+
     if (palette_to_set)
     {
         SDL_SetPaletteColors(screenbuffer->format->palette, palette, 0, 256);
+
+        for (i = 0; i < 256; i++)
+        {
+            rgbapalette[i] = SDL_MapRGB(rgbabuffer->format, palette[i].r,
+                                        palette[i].g, palette[i].b);
+        }
+
         palette_to_set = false;
     }
 
@@ -781,25 +962,63 @@ void I_FinishUpdate (void)
             palette[0].b, SDL_ALPHA_OPAQUE);
     }
 
-    // Blit from the paletted 8-bit screen buffer to the intermediate
-    // 32-bit RGBA buffer that we can load into the texture.
+    blitstart = I_GetTimeUS();
 
-    if (widescreen == -1 || widescreen == 0)
+    if (widescreen == 1)
     {
-        SDL_LowerBlit(screenbuffer, &blit_rect, rgbabuffer, &blit_rect);
+        blitrect = &w_blit_rect_16_9;
     }
-    else if (widescreen == 1)
+    else if (widescreen == 2)
     {
-        SDL_LowerBlit(screenbuffer, &w_blit_rect_16_9, rgbabuffer, &w_blit_rect_16_9);
+        blitrect = &w_blit_rect_16_10;
     }
-    else if (widescreen == 2)
+    else
     {
-        SDL_LowerBlit(screenbuffer, &w_blit_rect_16_10, rgbabuffer, &w_blit_rect_16_10);
+        blitrect = &blit_rect;
+    }
+
+    // [JN] Only the part of the screen drawn to since the last frame
+    // is converted and uploaded, unless the texture needs all of it.
+
+    if (fullblit)
+    {
+        dirty.x = 0;
+        dirty.y = 0;
+        dirty.w = screenwidth;
+        dirty.h = SCREENHEIGHT;
+        update = true;
+    }
+    else
+    {
+        update = GetDirtyRect(&dirty);
+    }
+
+    // [JN] Expand the paletted screen straight into the streaming
+    // texture. That saves the pass over the intermediate RGBA buffer
+    // and the copy SDL_UpdateTexture makes of it.
+
+    if (update && (sdlblit || !ExpandToTexture(&dirty, blitrect->w)))
+    {
+    // Blit from the paletted 8-bit screen buffer to the intermediate
+    // 32-bit RGBA buffer that we can load into the texture.
+
+    if (SDL_IntersectRect(&dirty, blitrect, &src))
+    {
+        SDL_LowerBlit(screenbuffer, &src, rgbabuffer, &src);
     }
 
     // Update the intermediate texture with the contents of the RGBA buffer.
 
-    SDL_UpdateTexture(texture, NULL, rgbabuffer->pixels, rgbabuffer->pitch);
+    SDL_UpdateTexture(texture, &dirty,
+                      (byte *) rgbabuffer->pixels + dirty.y * rgbabuffer->pitch
+                      + dirty.x * rgbabuffer->format->BytesPerPixel,
+                      rgbabuffer->pitch);
+    }
+
+    fullblit = false;
+    V_ClearDirtyBox();
+
+    rendered_blittime = (int) (I_GetTimeUS() - blitstart);
 
     // Make sure the pillarboxes are kept clear each frame.
 
@@ -870,6 +1089,7 @@ void I_SetPalette (byte *doompalette)
     }
 
     palette_to_set = true;
+    palette_cube_stale = true;
 }
 
 // Given an RGB value, find the closest matching palette index.
@@ -879,6 +1099,37 @@ int I_GetPaletteIndex(int r, int g, int b)
     int best, best_diff, diff;
     int i;
 
+    // [JN] Colours inside the RGB cube are looked up through the inverse
+    // colour cube, which gives the same index as the search below.
+
+    if (r >= 0 && r <= 255 && g >= 0 && g <= 255 && b >= 0 && b <= 255)
+    {
+        if (palette_cube_stale)
+        {
+            byte rgb[256 * 3];
+
+            for (i = 0; i < 256; ++i)
+            {
+                rgb[i * 3] = palette[i].r;
+                rgb[i * 3 + 1] = palette[i].g;
+                rgb[i * 3 + 2] = palette[i].b;
+            }
+
+            if (palette_cube == NULL)
+            {
+                palette_cube = V_NewPaletteCube(rgb);
+            }
+            else
+            {
+                V_SetCubePalette(palette_cube, rgb);
+            }
+
+            palette_cube_stale = false;
+        }
+
+        return V_NearestColor(palette_cube, r, g, b);
+    }
+
     best = 0; best_diff = INT_MAX;
 
     for (i = 0; i < 256; ++i)
@@ -965,6 +1216,15 @@ void I_GraphicsCheckCommandLine(void)
 
     noblit = M_CheckParm ("-noblit");
 
+    //!
+    // @category video
+    //
+    // Convert the screen with SDL_LowerBlit through an intermediate
+    // RGBA buffer instead of the threaded palette expansion.
+    //
+
+    sdlblit = M_ParmExists("-sdlblit");
+
     //!
     // @category video 
     //
@@ -1378,6 +1638,7 @@ static void SetVideoMode(void)
                                 pixel_format,
                                 SDL_TEXTUREACCESS_STREAMING,
                                 screenwidth, SCREENHEIGHT);
+    fullblit = true;
 
     // Initially create the upscaled texture for rendering to screen
 
@@ -1558,6 +1819,9 @@ void I_ReInitGraphics (int reinit)
 		                                  screenwidth, SCREENHEIGHT, 32,
 		                                  rmask, gmask, bmask, amask);
 
+		// [JN] rgbapalette is mapped to the format of rgbabuffer.
+		palette_to_set = true;
+
 		I_VideoBuffer = rgbabuffer->pixels;
 
 		V_RestoreBuffer();
@@ -1601,6 +1865,7 @@ void I_ReInitGraphics (int reinit)
 		                            pixel_format,
 		                            SDL_TEXTUREACCESS_STREAMING,
 		                            screenwidth, SCREENHEIGHT);
+		fullblit = true;
 
 		// [crispy] force its re-creation
 		CreateUpscaledTexture(true);
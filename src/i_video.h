@@ -82,6 +82,8 @@ int I_GetPaletteIndex(int r, int g, int b);
 // void I_UpdateNoBlit (void);
 void I_FinishUpdate (void);
 
+extern int rendered_blittime; // [JN] Time spent converting the screen in last frame, us
+
 void I_ReadScreen (byte* scr);
 
 void I_BeginRead (void);
@@ -0,0 +1,241 @@
+//
+// Copyright(C) 2016-2019 Julian Nechaevsky
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// DESCRIPTION:
+//      -benchmark: per-phase frame timings of a timed demo.
+//
+//      Every phase keeps one sample per frame, in microseconds.
+//      The report sorts the samples and gives min, median, 99th
+//      percentile and max, to stdout and optionally to a JSON or
+//      CSV file.
+//
+
+
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "i_system.h"
+#include "i_timer.h"
+#include "m_argv.h"
+#include "m_bench.h"
+#include "m_misc.h"
+#include "jn.h"
+
+
+boolean benchmarking = false;
+
+static const char *phasenames[NUMBENCHPHASES] =
+{
+    "P_Ticker",
+    "R_RenderBSPNode",
+    "R_DrawPlanes",
+    "R_DrawMasked",
+    "I_FinishUpdate",
+    "S_UpdateSounds",
+    "frame",
+};
+
+static char *benchdemo;
+static char *benchout;
+
+static uint64_t phasestart[NUMBENCHPHASES];
+static uint64_t phasetime[NUMBENCHPHASES];
+static uint64_t framestart;
+
+// Per frame samples, numframes of them for every phase.
+static unsigned int *samples[NUMBENCHPHASES];
+static int numframes;
+static int maxframes;
+
+void M_BenchStart(const char *demoname)
+{
+    int p;
+
+    //!
+    // @arg <file>
+    // @category demo
+    //
+    // With -benchmark, write the timings to file. Files ending in
+    // .csv get comma separated values, anything else gets JSON.
+    //
+
+    p = M_CheckParmWithArgs("-benchout", 1);
+
+    if (p)
+    {
+        benchout = M_StringDuplicate(myargv[p + 1]);
+    }
+
+    benchdemo = M_StringDuplicate(demoname);
+    benchmarking = true;
+    numframes = 0;
+    framestart = I_GetTimeUS();
+}
+
+void M_BenchBegin(benchphase_t phase)
+{
+    if (benchmarking)
+    {
+        phasestart[phase] = I_GetTimeUS();
+    }
+}
+
+void M_BenchEnd(benchphase_t phase)
+{
+    if (benchmarking)
+    {
+        phasetime[phase] += I_GetTimeUS() - phasestart[phase];
+    }
+}
+
+void M_BenchFrame(void)
+{
+    uint64_t now;
+    int i;
+
+    if (!benchmarking)
+    {
+        return;
+    }
+
+    now = I_GetTimeUS();
+    phasetime[bench_frame] = now - framestart;
+    framestart = now;
+
+    if (numframes == maxframes)
+    {
+        maxframes = maxframes ? maxframes * 2 : 4096;
+
+        for (i = 0; i < NUMBENCHPHASES; i++)
+        {
+            samples[i] = I_Realloc(samples[i], maxframes * sizeof(**samples));
+        }
+    }
+
+    for (i = 0; i < NUMBENCHPHASES; i++)
+    {
+        samples[i][numframes] = (unsigned int) phasetime[i];
+        phasetime[i] = 0;
+    }
+
+    numframes++;
+}
+
+static int CompareSamples(const void *a, const void *b)
+{
+    unsigned int sa = *(const unsigned int *) a;
+    unsigned int sb = *(const unsigned int *) b;
+
+    return sa < sb ? -1 : sa > sb;
+}
+
+void M_BenchReport(void)
+{
+    unsigned int stats[NUMBENCHPHASES][4];
+    unsigned int *sorted;
+    FILE *f = NULL;
+    boolean csv;
+    int i;
+
+    if (!benchmarking)
+    {
+        return;
+    }
+
+    benchmarking = false;
+
+    if (numframes == 0)
+    {
+        return;
+    }
+
+    // Nearest rank percentiles. Samples are sorted in place, the
+    // report is made once at the end of the demo.
+    for (i = 0; i < NUMBENCHPHASES; i++)
+    {
+        sorted = samples[i];
+        qsort(sorted, numframes, sizeof(*sorted), CompareSamples);
+
+        stats[i][0] = sorted[0];
+        stats[i][1] = sorted[(numframes - 1) / 2];
+        stats[i][2] = sorted[(numframes * 99 + 99) / 100 - 1];
+        stats[i][3] = sorted[numframes - 1];
+    }
+
+    printf(english_language ?
+           "Benchmark of %s, %i frames (us):\n" :
+           "Замер %s, кадров: %i (мкс):\n",
+           benchdemo, numframes);
+    printf("  %-16s %8s %8s %8s %8s\n", "", "min", "median", "p99", "max");
+
+    for (i = 0; i < NUMBENCHPHASES; i++)
+    {
+        printf("  %-16s %8u %8u %8u %8u\n", phasenames[i],
+               stats[i][0], stats[i][1], stats[i][2], stats[i][3]);
+    }
+
+    if (benchout != NULL)
+    {
+        f = fopen(benchout, "w");
+    }
+
+    if (f == NULL)
+    {
+        if (benchout != NULL)
+        {
+            printf(english_language ?
+                   "M_BenchReport: can't write %s\n" :
+                   "M_BenchReport: невозможно записать %s\n", benchout);
+        }
+
+        return;
+    }
+
+    csv = M_StringEndsWith(benchout, ".csv");
+
+    if (csv)
+    {
+        fprintf(f, "phase,min_us,median_us,p99_us,max_us\n");
+    }
+    else
+    {
+        fprintf(f, "{\n  \"demo\": \"%s\",\n  \"frames\": %i,\n"
+                   "  \"unit\": \"us\",\n  \"phases\": {\n",
+                benchdemo, numframes);
+    }
+
+    for (i = 0; i < NUMBENCHPHASES; i++)
+    {
+        if (csv)
+        {
+            fprintf(f, "%s,%u,%u,%u,%u\n", phasenames[i],
+                    stats[i][0], stats[i][1], stats[i][2], stats[i][3]);
+        }
+        else
+        {
+            fprintf(f, "    \"%s\": { \"min\": %u, \"median\": %u, "
+                       "\"p99\": %u, \"max\": %u }%s\n", phasenames[i],
+                    stats[i][0], stats[i][1], stats[i][2], stats[i][3],
+                    i < NUMBENCHPHASES - 1 ? "," : "");
+        }
+    }
+
+    if (!csv)
+    {
+        fprintf(f, "  }\n}\n");
+    }
+
+    fclose(f);
+}
+
@@ -0,0 +1,54 @@
+//
+// Copyright(C) 2016-2019 Julian Nechaevsky
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// DESCRIPTION:
+//      -benchmark: per-phase frame timings of a timed demo.
+//
+
+
+#ifndef __M_BENCH__
+#define __M_BENCH__
+
+#include "doomtype.h"
+
+typedef enum
+{
+    bench_ticker,       // P_Ticker
+    bench_bsp,          // R_RenderBSPNode
+    bench_planes,       // R_DrawPlanes
+    bench_masked,       // R_DrawMasked
+    bench_finishupdate, // I_FinishUpdate
+    bench_sound,        // S_UpdateSounds
+    bench_frame,        // whole frame, measured by M_BenchFrame
+    NUMBENCHPHASES
+} benchphase_t;
+
+extern boolean benchmarking;
+
+// Starts collecting timings for the demo. Output file is taken
+// from -benchout.
+void M_BenchStart(const char *demoname);
+
+// Brackets one phase. Phases may run several times per frame,
+// their times add up.
+void M_BenchBegin(benchphase_t phase);
+void M_BenchEnd(benchphase_t phase);
+
+// Closes the timings of one frame.
+void M_BenchFrame(void);
+
+// Prints min/median/p99/max of every phase and writes -benchout.
+void M_BenchReport(void);
+
+#endif
+
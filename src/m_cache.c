@@ -0,0 +1,207 @@
+//
+// Copyright(C) 2016-2019 Julian Nechaevsky
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// DESCRIPTION:
+//      On-disk cache of tables generated at startup.
+//
+//      Every table is one file in the "cache" directory of the config
+//      directory. Its header holds the key the table was made for and
+//      a digest of the data. A table is used only if both match, so a
+//      change of WADs, engine version or table inputs, and a file
+//      left half written, all make the table be generated again.
+//
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <process.h>
+#define getpid _getpid
+#else
+#include <unistd.h>
+#endif
+
+#include "config.h"
+#include "m_argv.h"
+#include "m_cache.h"
+#include "m_config.h"
+#include "m_misc.h"
+#include "w_checksum.h"
+
+
+#define CACHEMAGIC "RDTABLE1"
+
+typedef struct
+{
+    char magic[8];
+    sha1_digest_t key;
+    sha1_digest_t digest;   // of the data
+    byte size[4];           // little endian
+} cacheheader_t;
+
+static int cache_enabled = -1;
+
+static boolean CacheEnabled(void)
+{
+    if (cache_enabled < 0)
+    {
+        //!
+        // @category obscure
+        //
+        // Don't read or write the cache of tables generated at
+        // startup, like the translucency map.
+        //
+
+        cache_enabled = !M_ParmExists("-nocache") && configdir != NULL;
+    }
+
+    return cache_enabled;
+}
+
+static char *CachePath(char *name)
+{
+    char *dir, *path;
+
+    dir = M_StringJoin(configdir, "cache", NULL);
+    M_MakeDirectory(dir);
+    path = M_StringJoin(dir, DIR_SEPARATOR_S, name, ".cache", NULL);
+    free(dir);
+
+    return path;
+}
+
+static void DataDigest(sha1_digest_t digest, void *buffer, size_t size)
+{
+    sha1_context_t context;
+
+    SHA1_Init(&context);
+    SHA1_Update(&context, buffer, size);
+    SHA1_Final(digest, &context);
+}
+
+void M_CacheKey(sha1_context_t *context, char *name, int version)
+{
+    sha1_digest_t wads;
+
+    W_Checksum(wads);
+
+    SHA1_Init(context);
+    SHA1_UpdateString(context, PACKAGE_STRING);
+    SHA1_Update(context, wads, sizeof(sha1_digest_t));
+    SHA1_UpdateString(context, name);
+    SHA1_UpdateInt32(context, version);
+}
+
+boolean M_CacheRead(char *name, sha1_digest_t key, void *buffer, size_t size)
+{
+    cacheheader_t header;
+    sha1_digest_t digest;
+    char *path;
+    FILE *f;
+    boolean result;
+
+    if (!CacheEnabled())
+    {
+        return false;
+    }
+
+    path = CachePath(name);
+    f = fopen(path, "rb");
+    free(path);
+
+    if (f == NULL)
+    {
+        return false;
+    }
+
+    result = fread(&header, sizeof(header), 1, f) == 1
+          && !memcmp(header.magic, CACHEMAGIC, sizeof(header.magic))
+          && !memcmp(header.key, key, sizeof(sha1_digest_t))
+          && header.size[0] == (size & 0xff)
+          && header.size[1] == ((size >> 8) & 0xff)
+          && header.size[2] == ((size >> 16) & 0xff)
+          && header.size[3] == ((size >> 24) & 0xff)
+          && fread(buffer, 1, size, f) == size;
+
+    fclose(f);
+
+    if (result)
+    {
+        DataDigest(digest, buffer, size);
+        result = !memcmp(digest, header.digest, sizeof(sha1_digest_t));
+    }
+
+    return result;
+}
+
+void M_CacheWrite(char *name, sha1_digest_t key, void *buffer, size_t size)
+{
+    cacheheader_t header;
+    char *path, *temp;
+    size_t templen;
+    FILE *f;
+    boolean ok;
+
+    if (!CacheEnabled())
+    {
+        return;
+    }
+
+    memcpy(header.magic, CACHEMAGIC, sizeof(header.magic));
+    memcpy(header.key, key, sizeof(sha1_digest_t));
+    DataDigest(header.digest, buffer, size);
+    header.size[0] = size & 0xff;
+    header.size[1] = (size >> 8) & 0xff;
+    header.size[2] = (size >> 16) & 0xff;
+    header.size[3] = (size >> 24) & 0xff;
+
+    // Write a new file and put it in place of the old one, so that
+    // other instances never see a half written table. Every process
+    // writes its own file, instances started together don't share it.
+
+    path = CachePath(name);
+    templen = strlen(path) + 32;
+    temp = malloc(templen);
+
+    if (temp == NULL)
+    {
+        free(path);
+        return;
+    }
+
+    M_snprintf(temp, templen, "%s.%d.tmp", path, (int) getpid());
+    f = fopen(temp, "wb");
+
+    if (f != NULL)
+    {
+        ok = fwrite(&header, sizeof(header), 1, f) == 1
+          && fwrite(buffer, 1, size, f) == size;
+        ok = fclose(f) == 0 && ok;
+
+#ifdef _WIN32
+        // rename() doesn't replace an existing file here
+        remove(path);
+#endif
+
+        if (!ok || rename(temp, path) != 0)
+        {
+            remove(temp);
+        }
+    }
+
+    free(temp);
+    free(path);
+}
+
@@ -0,0 +1,39 @@
+//
+// Copyright(C) 2016-2019 Julian Nechaevsky
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// DESCRIPTION:
+//      On-disk cache of tables generated at startup.
+//
+
+
+#ifndef __M_CACHE__
+#define __M_CACHE__
+
+#include "doomtype.h"
+#include "sha1.h"
+
+// Starts the key of a cached table with the engine version, the WAD
+// directory, the table name and its version. Bump the version when the
+// code that generates the table changes. Callers add every other input
+// of the table to the context, then finish it with SHA1_Final.
+void M_CacheKey(sha1_context_t *context, char *name, int version);
+
+// Reads table name into buffer. Returns false if it isn't cached for
+// this key, the file is damaged or the cache is disabled.
+boolean M_CacheRead(char *name, sha1_digest_t key, void *buffer, size_t size);
+
+// Saves table name for this key, replacing any older copy.
+void M_CacheWrite(char *name, sha1_digest_t key, void *buffer, size_t size);
+
+#endif
+
@@ -1622,6 +1622,7 @@ static default_t extra_defaults_list[] =
     CONFIG_VARIABLE_INT(show_diskicon),
     CONFIG_VARIABLE_INT(screen_wiping),
     CONFIG_VARIABLE_INT(png_screenshots),
+    CONFIG_VARIABLE_INT(render_threads),    // [JN] Doom only
 
     // Display
     CONFIG_VARIABLE_INT(screenblocks),
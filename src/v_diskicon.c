@@ -133,6 +133,8 @@ void V_DrawDiskIcon(void)
         CopyRegion(DiskRegionPointer(), screenwidth,
                    disk_data, LOADING_DISK_W,
                    LOADING_DISK_W, LOADING_DISK_H);
+        V_MarkScreen(loading_disk_xoffs, loading_disk_yoffs,
+                     LOADING_DISK_W, LOADING_DISK_H);
         disk_drawn = true;
     }
 
@@ -147,6 +149,8 @@ void V_RestoreDiskBackground(void)
         CopyRegion(DiskRegionPointer(), screenwidth,
                    saved_background, LOADING_DISK_W,
                    LOADING_DISK_W, LOADING_DISK_H);
+        V_MarkScreen(loading_disk_xoffs, loading_disk_yoffs,
+                     LOADING_DISK_W, LOADING_DISK_H);
 
         disk_drawn = false;
     }
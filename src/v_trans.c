@@ -16,14 +16,17 @@
 
 
 #include <stdlib.h>
+#include <limits.h>
 #include <math.h>
 #include <string.h> // [crispy] strcmp()
 
 #include "doomtype.h"
 #include "deh_str.h"
+#include "i_system.h"
 #include "m_argv.h" // [crispy] M_ParmExists()
 #include "m_misc.h"
 #include "v_trans.h"
+#include "jn.h"
 
 
 // -----------------------------------------------------------------------------
@@ -595,4 +598,314 @@ byte *cr[] =
     (byte *) &cr_gray2green_hexen,
     (byte *) &cr_gray2red_hexen,
 };
- 
\ No newline at end of file
+ 
+
+
+// -----------------------------------------------------------------------------
+// [JN] Inverse colour cube.
+//
+// RGB space is split into CUBESIZE^3 cells. Every cell keeps the palette
+// entries that can be the nearest one to some point of the cell: those
+// whose closest distance to the cell is not larger than the smallest
+// farthest distance of any entry. Nearest colour searches only have to
+// look at these few candidates and still give the same answer as a
+// search of the whole palette, ties included.
+//
+// Cells are filled in the first time they are looked up, so setting a
+// new palette costs nothing until colours are asked for. A coarser cube
+// of BLOCKSIZE^3 blocks is kept the same way, and a cell only checks the
+// candidates of its block instead of all 256 entries.
+// -----------------------------------------------------------------------------
+
+#define CUBEBITS    4
+#define CUBESIZE    (1 << CUBEBITS)
+#define CELLSHIFT   (8 - CUBEBITS)
+
+#define BLOCKBITS   3
+#define BLOCKSIZE   (1 << BLOCKBITS)
+#define BLOCKSHIFT  (8 - BLOCKBITS)
+
+struct palcube_s
+{
+    byte palette[256 * 3];
+    byte all[256];                                  // 0 ... 255
+    int block[BLOCKSIZE * BLOCKSIZE * BLOCKSIZE];   // offset in pool, or -1
+    int cell[CUBESIZE * CUBESIZE * CUBESIZE];       // offset in pool, or -1
+    byte *pool;     // candidate counts and lists of filled cells
+    int poolsize;
+    int poolused;
+};
+
+static void CheckPaletteCube(palcube_t *cube);
+
+palcube_t *V_NewPaletteCube(const byte *palette)
+{
+    palcube_t *cube;
+    int i;
+
+    cube = malloc(sizeof(*cube));
+
+    if (cube == NULL)
+    {
+        I_Error(english_language ?
+                "V_NewPaletteCube: out of memory" :
+                "V_NewPaletteCube: недостаточно памяти");
+    }
+
+    for (i = 0; i < 256; i++)
+    {
+        cube->all[i] = i;
+    }
+
+    cube->pool = NULL;
+    cube->poolsize = 0;
+    V_SetCubePalette(cube, palette);
+
+    //!
+    // @category video
+    //
+    // Compare the inverse colour cube against a search of the whole
+    // palette when it is created, and quit with an error on the first
+    // colour they disagree on.
+    //
+
+    if (M_ParmExists("-palcheck"))
+    {
+        CheckPaletteCube(cube);
+    }
+
+    return cube;
+}
+
+void V_SetCubePalette(palcube_t *cube, const byte *palette)
+{
+    memcpy(cube->palette, palette, sizeof(cube->palette));
+    memset(cube->block, 0xff, sizeof(cube->block));
+    memset(cube->cell, 0xff, sizeof(cube->cell));
+    cube->poolused = 0;
+}
+
+void V_FreePaletteCube(palcube_t *cube)
+{
+    free(cube->pool);
+    free(cube);
+}
+
+// Squared distances from v to the nearest and the farthest point of
+// [lo, lo + size]. The upper edge is included, so that points with
+// a fraction, like blended colours, are covered as well.
+
+static void AxisDistance(int v, int lo, int size, int *mind, int *maxd)
+{
+    const int hi = lo + size;
+    int d;
+
+    d = v < lo ? lo - v : v > hi ? v - hi : 0;
+    *mind += d * d;
+
+    d = v - lo > hi - v ? v - lo : hi - v;
+    *maxd += d * d;
+}
+
+// Picks the candidates of a box out of the candidates of a box that
+// holds it and appends them to the pool. Returns their offset. The
+// caller makes room for them first, so that from can point into the
+// pool.
+
+static int FillList(palcube_t *cube, const byte *from, int fromcount,
+                    int r, int g, int b, int size)
+{
+    int mindist[256];
+    int bound, maxd, count;
+    const byte *p;
+    byte *list;
+    int i;
+
+    bound = INT_MAX;
+
+    for (i = 0; i < fromcount; i++)
+    {
+        p = cube->palette + from[i] * 3;
+        mindist[i] = maxd = 0;
+        AxisDistance(p[0], r, size, &mindist[i], &maxd);
+        AxisDistance(p[1], g, size, &mindist[i], &maxd);
+        AxisDistance(p[2], b, size, &mindist[i], &maxd);
+
+        if (maxd < bound)
+        {
+            bound = maxd;
+        }
+    }
+
+    list = cube->pool + cube->poolused + 1;
+    count = 0;
+
+    for (i = 0; i < fromcount; i++)
+    {
+        if (mindist[i] <= bound)
+        {
+            list[count++] = from[i];
+        }
+    }
+
+    // The count is kept less one, so all 256 entries fit in a byte.
+    // There is at least one: the entry that sets the bound.
+    cube->pool[cube->poolused] = count - 1;
+
+    i = cube->poolused;
+    cube->poolused += count + 1;
+
+    return i;
+}
+
+const byte *V_CubeCandidates(palcube_t *cube, int r, int g, int b, int *count)
+{
+    int *block, *cell;
+    const byte *list;
+
+    cell = &cube->cell[((r >> CELLSHIFT) << (CUBEBITS * 2))
+                     + ((g >> CELLSHIFT) << CUBEBITS)
+                     + (b >> CELLSHIFT)];
+
+    if (*cell < 0)
+    {
+        // A block and a cell, each one count byte and up to 256
+        // candidates.
+        if (cube->poolused + 2 * 257 > cube->poolsize)
+        {
+            cube->poolsize = cube->poolsize ? cube->poolsize * 2 : 16384;
+            cube->pool = I_Realloc(cube->pool, cube->poolsize);
+        }
+
+        block = &cube->block[((r >> BLOCKSHIFT) << (BLOCKBITS * 2))
+                           + ((g >> BLOCKSHIFT) << BLOCKBITS)
+                           + (b >> BLOCKSHIFT)];
+
+        if (*block < 0)
+        {
+            *block = FillList(cube, cube->all, 256,
+                              (r >> BLOCKSHIFT) << BLOCKSHIFT,
+                              (g >> BLOCKSHIFT) << BLOCKSHIFT,
+                              (b >> BLOCKSHIFT) << BLOCKSHIFT,
+                              1 << BLOCKSHIFT);
+        }
+
+        // Any entry that can be nearest in the cell can be nearest in
+        // its block as well.
+        *cell = FillList(cube, cube->pool + *block + 1,
+                         cube->pool[*block] + 1,
+                         (r >> CELLSHIFT) << CELLSHIFT,
+                         (g >> CELLSHIFT) << CELLSHIFT,
+                         (b >> CELLSHIFT) << CELLSHIFT,
+                         1 << CELLSHIFT);
+    }
+
+    list = cube->pool + *cell;
+    *count = list[0] + 1;
+
+    return list + 1;
+}
+
+int V_NearestColor(palcube_t *cube, int r, int g, int b)
+{
+    const byte *list, *p;
+    int best, best_diff, diff;
+    int count, i;
+
+    list = V_CubeCandidates(cube, r, g, b, &count);
+    best = list[0];
+    best_diff = INT_MAX;
+
+    // Candidates are in palette order, so ties go to the lowest
+    // index, like a search of the whole palette.
+    for (i = 0; i < count; i++)
+    {
+        p = cube->palette + list[i] * 3;
+        diff = (r - p[0]) * (r - p[0])
+             + (g - p[1]) * (g - p[1])
+             + (b - p[2]) * (b - p[2]);
+
+        if (diff < best_diff)
+        {
+            best = list[i];
+            best_diff = diff;
+
+            if (diff == 0)
+            {
+                break;
+            }
+        }
+    }
+
+    return best;
+}
+
+// -palcheck: look up colours at the edges and in the middle of every
+// cell, and compare them against a search of the whole palette.
+
+static int NearestColorLinear(const byte *palette, int r, int g, int b)
+{
+    const byte *p;
+    int best, best_diff, diff;
+    int i;
+
+    best = 0;
+    best_diff = INT_MAX;
+
+    for (i = 0; i < 256; i++)
+    {
+        p = palette + i * 3;
+        diff = (r - p[0]) * (r - p[0])
+             + (g - p[1]) * (g - p[1])
+             + (b - p[2]) * (b - p[2]);
+
+        if (diff < best_diff)
+        {
+            best = i;
+            best_diff = diff;
+        }
+    }
+
+    return best;
+}
+
+static void CheckPaletteCube(palcube_t *cube)
+{
+    static const int offsets[] = {
+        0, 1, (1 << CELLSHIFT) / 2 - 1, (1 << CELLSHIFT) / 2, (1 << CELLSHIFT) - 1
+    };
+    int samples[CUBESIZE * arrlen(offsets)];
+    int numsamples = 0;
+    int r, g, b;
+    int got, want;
+    int i, j;
+
+    for (i = 0; i < CUBESIZE; i++)
+    {
+        for (j = 0; j < (int) arrlen(offsets); j++)
+        {
+            samples[numsamples++] = (i << CELLSHIFT) + offsets[j];
+        }
+    }
+
+    for (r = 0; r < numsamples; r++)
+    {
+        for (g = 0; g < numsamples; g++)
+        {
+            for (b = 0; b < numsamples; b++)
+            {
+                got = V_NearestColor(cube, samples[r], samples[g], samples[b]);
+                want = NearestColorLinear(cube->palette,
+                                          samples[r], samples[g], samples[b]);
+
+                if (got != want)
+                {
+                    I_Error(english_language ?
+                            "V_NearestColor: %i for (%i, %i, %i), full search gives %i" :
+                            "V_NearestColor: %i для (%i, %i, %i), полный поиск даёт %i",
+                            got, samples[r], samples[g], samples[b], want);
+                }
+            }
+        }
+    }
+}
@@ -80,5 +80,22 @@ extern byte  *cr[CRMAX];
 extern char **crstr;
 extern byte  *tranmap;
 
+// [JN] Nearest colour lookup through an inverse colour cube.
+// Palettes are 256 RGB triplets, colours are 0..255 per channel.
+
+typedef struct palcube_s palcube_t;
+
+palcube_t *V_NewPaletteCube(const byte *palette);
+void V_SetCubePalette(palcube_t *cube, const byte *palette);
+void V_FreePaletteCube(palcube_t *cube);
+
+// Palette entries, in ascending order, that can be nearest to a colour
+// in the cell of r, g, b. Any metric that grows with the RGB distance
+// only has to check these.
+const byte *V_CubeCandidates(palcube_t *cube, int r, int g, int b, int *count);
+
+// Index of the nearest palette entry, lowest index on ties.
+int V_NearestColor(palcube_t *cube, int r, int g, int b);
+
 
 #endif // __V_TRANS__ 
@@ -67,7 +67,12 @@ byte *xlatab = NULL;
 
 static byte *dest_screen = NULL;
 
+// [JN] Bounding box of everything drawn to I_VideoBuffer since the last
+// I_FinishUpdate, in screen pixels. Only the pixels inside it are
+// converted and uploaded when dirtyrects is set.
+
 int dirtybox[4]; 
+boolean dirtyrects = false;
 
 // haleyjd 08/28/10: clipping callback function for patches.
 // This is needed for Chocolate Strife, which clips patches to the screen.
@@ -76,8 +81,23 @@ static vpatchclipfunc_t patchclip_callback = NULL;
 extern int draw_shadowed_text;
 int vanillaparm;
 
+//
+// V_MarkScreen
+// [JN] Adds a rectangle of I_VideoBuffer to the dirty box, whatever
+// buffer V_* functions are drawing to at the moment.
+//
+void V_MarkScreen(int x, int y, int width, int height)
+{
+    if (width > 0 && height > 0)
+    {
+        M_AddToBox (dirtybox, x, y);
+        M_AddToBox (dirtybox, x + width-1, y + height-1);
+    }
+}
+
 //
 // V_MarkRect 
+// Coordinates are in screen pixels.
 // 
 void V_MarkRect(int x, int y, int width, int height) 
 { 
@@ -86,10 +106,30 @@ void V_MarkRect(int x, int y, int width, int height)
 
     if (dest_screen == I_VideoBuffer)
     {
-        M_AddToBox (dirtybox, x, y); 
-        M_AddToBox (dirtybox, x + width-1, y + height-1); 
+        V_MarkScreen(x, y, width, height);
     }
 } 
+
+//
+// V_MarkPatch
+// [JN] Marks a patch drawn at x, y of the original screen, scaled by
+// factor and shifted by the size of its shadow, if any.
+//
+static void V_MarkPatch(int x, int y, patch_t *patch, int factor, int shadow)
+{
+    V_MarkRect(x * factor, y * factor,
+               (SHORT(patch->width) + shadow) * factor,
+               (SHORT(patch->height) + shadow) * factor);
+}
+
+//
+// V_ClearDirtyBox
+// [JN] Called by I_FinishUpdate once the dirty box is on the screen.
+//
+void V_ClearDirtyBox(void)
+{
+    M_ClearBox (dirtybox);
+}
  
 
 //
@@ -192,7 +232,7 @@ void V_DrawPatch(int x, int y, patch_t *patch)
     }
 #endif
 
-    V_MarkRect(x, y, SHORT(patch->width), SHORT(patch->height));
+    V_MarkPatch(x, y, patch, 1 << hires, 0);
 
     col = 0;
     desttop = dest_screen + (y << hires) * screenwidth + x;
@@ -309,7 +349,7 @@ void V_DrawPatchFlipped(int x, int y, patch_t *patch)
     }
 #endif
 
-    V_MarkRect (x, y, SHORT(patch->width), SHORT(patch->height));
+    V_MarkPatch(x, y, patch, 1 << hires, 0);
 
     col = 0;
     desttop = dest_screen + (y << hires) * screenwidth + x;
@@ -389,6 +429,8 @@ void V_DrawTLPatch(int x, int y, patch_t * patch)
     }
 #endif
 
+    V_MarkPatch(x, y, patch, 1 << hires, 0);
+
     col = 0;
     desttop = dest_screen + (y << hires) * screenwidth + x;
 
@@ -445,6 +487,8 @@ void V_DrawXlaPatch(int x, int y, patch_t * patch)
             return;
     }
 
+    V_MarkPatch(x, y, patch, 1 << hires, 0);
+
     col = 0;
     desttop = dest_screen + (y << hires) * screenwidth + x;
 
@@ -509,6 +553,8 @@ void V_DrawAltTLPatch(int x, int y, patch_t * patch)
     }
 #endif
 
+    V_MarkPatch(x, y, patch, 1 << hires, 0);
+
     col = 0;
     desttop = dest_screen + (y << hires) * screenwidth + x;
 
@@ -573,6 +619,8 @@ void V_DrawShadowedPatch(int x, int y, patch_t *patch)
     }
 #endif
 
+    V_MarkPatch(x, y, patch, 1 << hires, 2);
+
     col = 0;
     desttop = dest_screen + (y << hires) * screenwidth + x;
     desttop2 = dest_screen + ((y + 2) << hires) * screenwidth + x + 2;
@@ -646,6 +694,8 @@ void V_DrawShadowedPatchDoom(int x, int y, patch_t *patch)
     }
 #endif
 
+    V_MarkPatch(x, y, patch, 1 << hires, 2);
+
     col = 0;
     desttop = dest_screen + (y << hires) * screenwidth + x;
     
@@ -742,6 +792,8 @@ void V_DrawShadowedPatchRaven(int x, int y, patch_t *patch)
     }
 #endif
 
+    V_MarkPatch(x, y, patch, 1 << hires, 2);
+
     col = 0;
     desttop = dest_screen + (y << hires) * screenwidth + x;
     if (draw_shadowed_text && !vanillaparm)
@@ -846,7 +898,7 @@ void V_DrawPatchUnscaled(int x, int y, patch_t *patch)
     }
 #endif
 
-    V_MarkRect(x, y, SHORT(patch->width), SHORT(patch->height));
+    V_MarkPatch(x, y, patch, 1, 0);
 
     col = 0;
     desttop = dest_screen + y * screenwidth + x;
@@ -911,7 +963,7 @@ void V_DrawPatchFinale(int x, int y, patch_t *patch)
     }
 #endif
 
-    V_MarkRect(x, y, SHORT(patch->width), SHORT(patch->height));
+    V_MarkPatch(x, y, patch, 4, 0);
 
     col = 0;
     desttop = dest_screen 
@@ -1007,7 +1059,7 @@ void V_DrawBlock(int x, int y, int width, int height, byte *src)
     }
 #endif 
  
-    V_MarkRect (x, y, width, height); 
+    V_MarkRect (x, y << hires, width, height); 
  
     dest = dest_screen + (y << hires) * screenwidth + x;
 
@@ -1036,7 +1088,7 @@ void V_DrawScaledBlock(int x, int y, int width, int height, byte *src)
     }
 #endif
 
-    V_MarkRect (x, y, width, height);
+    V_MarkRect (x << hires, y << hires, width << hires, height << hires);
 
     dest = dest_screen + (y << hires) * screenwidth + (x << hires);
 
@@ -1054,6 +1106,8 @@ void V_DrawFilledBox(int x, int y, int w, int h, int c)
     uint8_t *buf, *buf1;
     int x1, y1;
 
+    V_MarkScreen(x, y, w, h);
+
     buf = I_VideoBuffer + screenwidth * y + x;
 
     for (y1 = 0; y1 < h; ++y1)
@@ -1074,6 +1128,8 @@ void V_DrawHorizLine(int x, int y, int w, int c)
     uint8_t *buf;
     int x1;
 
+    V_MarkScreen(x, y, w, 1);
+
     buf = I_VideoBuffer + screenwidth * y + x;
 
     for (x1 = 0; x1 < w; ++x1)
@@ -1087,6 +1143,8 @@ void V_DrawVertLine(int x, int y, int h, int c)
     uint8_t *buf;
     int y1;
 
+    V_MarkScreen(x, y, 1, h);
+
     buf = I_VideoBuffer + screenwidth * y + x;
 
     for (y1 = 0; y1 < h; ++y1)
@@ -1161,6 +1219,7 @@ void V_CopyScaledBuffer(byte *dest, byte *src, size_t size)
  
 void V_DrawRawScreen(byte *raw)
 {
+    V_MarkRect(0, 0, screenwidth, SCREENHEIGHT);
     V_CopyScaledBuffer(dest_screen, raw, ORIGWIDTH * ORIGHEIGHT);
 }
 
@@ -37,6 +37,7 @@
 
 
 extern int dirtybox[4];
+extern boolean dirtyrects;
 
 extern byte *tinttable;
 extern byte *dp_translation;
@@ -75,6 +76,8 @@ void V_DrawBlock(int x, int y, int width, int height, byte *src);
 void V_DrawScaledBlock(int x, int y, int width, int height, byte *src);
 
 void V_MarkRect(int x, int y, int width, int height);
+void V_MarkScreen(int x, int y, int width, int height);
+void V_ClearDirtyBox(void);
 
 void V_DrawFilledBox(int x, int y, int w, int h, int c);
 void V_DrawHorizLine(int x, int y, int w, int c);
@@ -52,14 +52,31 @@ static wad_file_class_t *wad_file_classes[] =
 wad_file_t *W_OpenFile(char *path)
 {
     wad_file_t *result;
+    boolean use_mmap;
     int i;
 
     //!
     // Use the OS's virtual memory subsystem to map WAD files
-    // directly into memory.
+    // directly into memory. This is the default on Linux.
     //
 
-    if (!M_CheckParm("-mmap"))
+    use_mmap = M_CheckParm("-mmap") > 0;
+
+#ifdef __linux__
+    use_mmap = true;
+#endif
+
+    //!
+    // Don't map WAD files into memory, read lumps into the zone
+    // instead.
+    //
+
+    if (M_CheckParm("-nommap"))
+    {
+        use_mmap = false;
+    }
+
+    if (!use_mmap)
     {
         return stdc_wad_file.OpenFile(path);
     }
@@ -92,3 +109,40 @@ size_t W_Read(wad_file_t *wad, unsigned int offset,
     return wad->file_class->Read(wad, offset, buffer, buffer_len);
 }
 
+size_t W_ReadV(wad_file_t *wad, unsigned int offset,
+               wad_readvec_t *vecs, int count)
+{
+    size_t result, c;
+    int i;
+
+    if (wad->file_class->ReadV != NULL)
+    {
+        return wad->file_class->ReadV(wad, offset, vecs, count);
+    }
+
+    result = 0;
+
+    for (i = 0; i < count; ++i)
+    {
+        c = W_Read(wad, offset, vecs[i].buffer, vecs[i].len);
+        result += c;
+
+        if (c < vecs[i].len)
+        {
+            break;
+        }
+
+        offset += c;
+    }
+
+    return result;
+}
+
+void W_Prefetch(wad_file_t *wad, unsigned int offset, size_t len)
+{
+    if (wad->file_class->Prefetch != NULL)
+    {
+        wad->file_class->Prefetch(wad, offset, len);
+    }
+}
+
@@ -27,6 +27,14 @@
 
 typedef struct _wad_file_s wad_file_t;
 
+// One destination buffer of a vectored read.
+
+typedef struct
+{
+    void *buffer;
+    size_t len;
+} wad_readvec_t;
+
 typedef struct
 {
     // Open a file for reading.
@@ -39,6 +47,15 @@ typedef struct
     // provided buffer.  Returns the number of bytes read.
     size_t (*Read)(wad_file_t *file, unsigned int offset,
                    void *buffer, size_t buffer_len);
+
+    // Read consecutive data starting at the specified position into
+    // several buffers with one call. Returns the number of bytes read.
+    // May be NULL, Read is then called for every buffer.
+    size_t (*ReadV)(wad_file_t *file, unsigned int offset,
+                    wad_readvec_t *vecs, int count);
+
+    // Hint that the specified range will be read soon. May be NULL.
+    void (*Prefetch)(wad_file_t *file, unsigned int offset, size_t len);
 } wad_file_class_t;
 
 struct _wad_file_s
@@ -73,4 +90,14 @@ void W_CloseFile(wad_file_t *wad);
 size_t W_Read(wad_file_t *wad, unsigned int offset,
               void *buffer, size_t buffer_len);
 
+// Read consecutive data from the specified file into several buffers,
+// filling each in turn. Returns the total number of bytes read.
+
+size_t W_ReadV(wad_file_t *wad, unsigned int offset,
+               wad_readvec_t *vecs, int count);
+
+// Ask the OS to start reading the specified range in the background.
+
+void W_Prefetch(wad_file_t *wad, unsigned int offset, size_t len);
+
 #endif /* #ifndef __W_FILE__ */
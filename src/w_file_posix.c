@@ -42,7 +42,7 @@ typedef struct
 
 extern wad_file_class_t posix_wad_file;
 
-static void MapFile(posix_wad_file_t *wad, char *filename)
+static boolean MapFile(posix_wad_file_t *wad, char *filename)
 {
     void *result;
     int protection;
@@ -60,19 +60,37 @@ static void MapFile(posix_wad_file_t *wad, char *filename)
 
     flags = MAP_PRIVATE;
 
+    // [JN] Empty files can't be mapped, leave them to stdc.
+
+    if (wad->wad.length == 0)
+    {
+        return false;
+    }
+
     result = mmap(NULL, wad->wad.length,
                   protection, flags, 
                   wad->handle, 0);
 
-    wad->wad.mapped = result;
-
-    if (result == NULL)
+    if (result == MAP_FAILED)
     {
         fprintf(stderr, english_language ?
                         "W_POSIX_OpenFile: Unable to mmap() %s - %s\n" :
                         "W_POSIX_OpenFile: ошибка mmap() %s - %s\n",
                         filename, strerror(errno));
+        return false;
     }
+
+#ifdef MADV_WILLNEED
+    // [JN] Start reading the whole file in the background. Lumps are
+    // then served from the page cache instead of faulting in page by
+    // page on first use. Only a hint, errors don't matter.
+
+    madvise(result, wad->wad.length, MADV_WILLNEED);
+#endif
+
+    wad->wad.mapped = result;
+
+    return true;
 }
 
 unsigned int GetFileLength(int handle)
@@ -85,7 +103,7 @@ static wad_file_t *W_POSIX_OpenFile(char *path)
     posix_wad_file_t *result;
     int handle;
 
-    handle = open(path, 0);
+    handle = open(path, O_RDONLY);
 
     if (handle < 0)
     {
@@ -97,12 +115,20 @@ static wad_file_t *W_POSIX_OpenFile(char *path)
     result = Z_Malloc(sizeof(posix_wad_file_t), PU_STATIC, 0);
     result->wad.file_class = &posix_wad_file;
     result->wad.length = GetFileLength(handle);
-    result->wad.path = M_StringDuplicate(path);
+    result->wad.mapped = NULL;
     result->handle = handle;
 
-    // Try to map the file into memory with mmap:
+    // Try to map the file into memory with mmap. If that fails, give
+    // up so that W_OpenFile falls back to the stdc class.
 
-    MapFile(result, path);
+    if (!MapFile(result, path))
+    {
+        close(handle);
+        Z_Free(result);
+        return NULL;
+    }
+
+    result->wad.path = M_StringDuplicate(path);
 
     return &result->wad;
 }
@@ -115,6 +141,11 @@ static void W_POSIX_CloseFile(wad_file_t *wad)
 
     // If mapped, unmap it.
 
+    if (posix_wad->wad.mapped != NULL)
+    {
+        munmap(posix_wad->wad.mapped, posix_wad->wad.length);
+    }
+
     // Close the file
   
     close(posix_wad->handle);
@@ -134,6 +165,25 @@ size_t W_POSIX_Read(wad_file_t *wad, unsigned int offset,
 
     posix_wad = (posix_wad_file_t *) wad;
 
+    // [JN] Copy straight out of the mapping, no need for syscalls.
+
+    if (wad->mapped != NULL)
+    {
+        if (offset >= wad->length)
+        {
+            return 0;
+        }
+
+        if (buffer_len > wad->length - offset)
+        {
+            buffer_len = wad->length - offset;
+        }
+
+        memcpy(buffer, wad->mapped + offset, buffer_len);
+
+        return buffer_len;
+    }
+
     // Jump to the specified position in the file.
 
     lseek(posix_wad->handle, offset, SEEK_SET);
@@ -163,12 +213,46 @@ size_t W_POSIX_Read(wad_file_t *wad, unsigned int offset,
     return bytes_read;
 }
 
+// [JN] Fault in the pages of a range ahead of use.
+
+static void W_POSIX_Prefetch(wad_file_t *wad, unsigned int offset, size_t len)
+{
+#ifdef MADV_WILLNEED
+    static uintptr_t pagemask;
+    uintptr_t start;
+
+    if (wad->mapped == NULL || offset >= wad->length)
+    {
+        return;
+    }
+
+    if (pagemask == 0)
+    {
+        pagemask = (uintptr_t) sysconf(_SC_PAGESIZE) - 1;
+    }
+
+    if (len > wad->length - offset)
+    {
+        len = wad->length - offset;
+    }
+
+    // madvise wants a page aligned address.
+
+    start = (uintptr_t) (wad->mapped + offset) & ~pagemask;
+    len += (uintptr_t) (wad->mapped + offset) - start;
+
+    madvise((void *) start, len, MADV_WILLNEED);
+#endif
+}
+
 
 wad_file_class_t posix_wad_file = 
 {
     W_POSIX_OpenFile,
     W_POSIX_CloseFile,
     W_POSIX_Read,
+    NULL,
+    W_POSIX_Prefetch,
 };
 
 
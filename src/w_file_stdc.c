@@ -21,6 +21,17 @@
 
 #include <stdio.h>
 
+#include "config.h"
+
+#if defined(HAVE_PREAD) || defined(HAVE_POSIX_FADVISE)
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#ifdef HAVE_PREADV
+#include <sys/uio.h>
+#endif
+
 #include "m_misc.h"
 #include "w_file.h"
 #include "z_zone.h"
@@ -78,6 +89,30 @@ size_t W_StdC_Read(wad_file_t *wad, unsigned int offset,
 
     stdc_wad = (stdc_wad_file_t *) wad;
 
+#ifdef HAVE_PREAD
+    // [JN] Positioned reads, one syscall and no stdio buffering.
+    {
+        byte *byte_buffer = buffer;
+        ssize_t c;
+
+        result = 0;
+
+        while (buffer_len > 0)
+        {
+            c = pread(fileno(stdc_wad->fstream), byte_buffer,
+                      buffer_len, offset + result);
+
+            if (c <= 0)
+            {
+                break;
+            }
+
+            byte_buffer += c;
+            buffer_len -= c;
+            result += c;
+        }
+    }
+#else
     // Jump to the specified position in the file.
 
     fseek(stdc_wad->fstream, offset, SEEK_SET);
@@ -85,16 +120,115 @@ size_t W_StdC_Read(wad_file_t *wad, unsigned int offset,
     // Read into the buffer.
 
     result = fread(buffer, 1, buffer_len, stdc_wad->fstream);
+#endif
 
     return result;
 }
 
+#ifdef HAVE_PREADV
+
+// [JN] Read several lumps lying next to each other in the file with a
+// single syscall. Short reads are finished off buffer by buffer.
+
+#define MAXREADVECS 128
+
+static size_t W_StdC_ReadV(wad_file_t *wad, unsigned int offset,
+                           wad_readvec_t *vecs, int count)
+{
+    stdc_wad_file_t *stdc_wad;
+    struct iovec iov[MAXREADVECS];
+    size_t result, skip, c;
+    ssize_t got;
+    int i, n;
+
+    stdc_wad = (stdc_wad_file_t *) wad;
+    result = 0;
+
+    while (count > 0)
+    {
+        n = count < MAXREADVECS ? count : MAXREADVECS;
+
+        for (i = 0; i < n; ++i)
+        {
+            iov[i].iov_base = vecs[i].buffer;
+            iov[i].iov_len = vecs[i].len;
+        }
+
+        got = preadv(fileno(stdc_wad->fstream), iov, n, offset);
+
+        if (got < 0)
+        {
+            got = 0;
+        }
+
+        // Step over the buffers that were filled.
+
+        skip = got;
+
+        for (i = 0; i < n && skip >= vecs[i].len; ++i)
+        {
+            skip -= vecs[i].len;
+        }
+
+        result += got;
+        offset += got;
+
+        if (i < n)
+        {
+            // Short read, finish this buffer the slow way.
+
+            c = W_StdC_Read(wad, offset, (byte *) vecs[i].buffer + skip,
+                            vecs[i].len - skip);
+            result += c;
+            offset += c;
+
+            if (c < vecs[i].len - skip)
+            {
+                break;
+            }
+
+            ++i;
+        }
+
+        vecs += i;
+        count -= i;
+    }
+
+    return result;
+}
+
+#endif
+
+#ifdef HAVE_POSIX_FADVISE
+
+static void W_StdC_Prefetch(wad_file_t *wad, unsigned int offset, size_t len)
+{
+    stdc_wad_file_t *stdc_wad;
+
+    stdc_wad = (stdc_wad_file_t *) wad;
+
+    posix_fadvise(fileno(stdc_wad->fstream), offset, len,
+                  POSIX_FADV_WILLNEED);
+}
+
+#endif
+
 
 wad_file_class_t stdc_wad_file = 
 {
     W_StdC_OpenFile,
     W_StdC_CloseFile,
     W_StdC_Read,
+#ifdef HAVE_PREADV
+    W_StdC_ReadV,
+#else
+    NULL,
+#endif
+#ifdef HAVE_POSIX_FADVISE
+    W_StdC_Prefetch,
+#else
+    NULL,
+#endif
 };
 
 
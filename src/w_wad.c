@@ -485,6 +485,186 @@ void *W_CacheLumpNum(lumpindex_t lumpnum, int tag)
 
 
 
+//
+// W_CacheLumps
+// Loads a set of lumps into the cache, as W_CacheLumpNum does for each
+// of them, but in file order: lumps lying next to each other are read
+// with one call. Used for precaching, where the lumps come in texture
+// and sprite order and would otherwise mean a seek and a read apiece.
+//
+
+#define MAXBATCHLUMPS   64      // lumps held static by one batch
+#define MAXBATCHGAP     4096    // bytes read past between two lumps
+
+static int W_CompareLumpPositions(const void *a, const void *b)
+{
+    lumpindex_t la = *(const lumpindex_t *) a;
+    lumpindex_t lb = *(const lumpindex_t *) b;
+    const lumpinfo_t *ia = lumpinfo[la];
+    const lumpinfo_t *ib = lumpinfo[lb];
+
+    if (ia->wad_file != ib->wad_file)
+    {
+        return (uintptr_t) ia->wad_file < (uintptr_t) ib->wad_file ? -1 : 1;
+    }
+
+    if (ia->position != ib->position)
+    {
+        return ia->position < ib->position ? -1 : 1;
+    }
+
+    return la - lb;
+}
+
+static void W_ReadLumpBatch(const lumpindex_t *batch, int count)
+{
+    static byte gap[MAXBATCHGAP];
+    wad_readvec_t vecs[MAXBATCHLUMPS * 2];
+    lumpinfo_t *first, *l;
+    unsigned int end;
+    size_t expected, c;
+    int numvecs;
+    int i, j;
+
+    for (i = 0; i < count; i = j)
+    {
+        first = lumpinfo[batch[i]];
+        end = first->position;
+        expected = 0;
+        numvecs = 0;
+
+        // Gather the following lumps of the same file, reading through
+        // small holes between them into a scratch buffer.
+
+        for (j = i; j < count; ++j)
+        {
+            l = lumpinfo[batch[j]];
+
+            if (j > i && (l->wad_file != first->wad_file
+                       || l->position < end
+                       || l->position - end > MAXBATCHGAP))
+            {
+                break;
+            }
+
+            if (l->position > end)
+            {
+                vecs[numvecs].buffer = gap;
+                vecs[numvecs].len = l->position - end;
+                expected += vecs[numvecs].len;
+                ++numvecs;
+            }
+
+            vecs[numvecs].buffer = l->cache;
+            vecs[numvecs].len = l->size;
+            expected += l->size;
+            ++numvecs;
+
+            end = l->position + l->size;
+        }
+
+        V_BeginRead(expected);
+
+        c = W_ReadV(first->wad_file, first->position, vecs, numvecs);
+
+        if (c < expected)
+        {
+            I_Error(english_language ?
+                    "W_CacheLumps: only read %i of %i on lump %i" :
+                    "W_CacheLumps: прочитано только %i из %i в блоке %i",
+                    (int) c, (int) expected, batch[i]);
+        }
+    }
+}
+
+void W_CacheLumps(const lumpindex_t *lumps, int count, int tag)
+{
+    lumpindex_t *order;
+    lumpindex_t batch[MAXBATCHLUMPS];
+    lumpinfo_t *l;
+    int numorder, numbatch;
+    int i, j;
+
+    order = malloc(count * sizeof(*order));
+    numorder = 0;
+
+    for (i = 0; i < count; ++i)
+    {
+        if ((unsigned) lumps[i] >= numlumps)
+        {
+            I_Error ("W_CacheLumps: %i >= numlumps", lumps[i]);
+        }
+
+        // Lumps of memory-mapped files are never copied.
+
+        if (lumpinfo[lumps[i]]->wad_file->mapped == NULL)
+        {
+            order[numorder++] = lumps[i];
+        }
+    }
+
+    qsort(order, numorder, sizeof(*order), W_CompareLumpPositions);
+
+    for (i = 0; i < numorder; i = j)
+    {
+        // New lumps stay static until they are read, so that the
+        // allocations of the same batch can't purge them.
+
+        numbatch = 0;
+
+        for (j = i; j < numorder && numbatch < MAXBATCHLUMPS; ++j)
+        {
+            if (j > 0 && order[j] == order[j - 1])
+            {
+                continue;
+            }
+
+            l = lumpinfo[order[j]];
+
+            if (l->cache != NULL)
+            {
+                Z_ChangeTag(l->cache, tag);
+            }
+            else
+            {
+                l->cache = Z_Malloc(l->size, PU_STATIC, &l->cache);
+                batch[numbatch++] = order[j];
+            }
+        }
+
+        W_ReadLumpBatch(batch, numbatch);
+
+        for (numbatch--; numbatch >= 0; numbatch--)
+        {
+            Z_ChangeTag(lumpinfo[batch[numbatch]]->cache, tag);
+        }
+    }
+
+    free(order);
+}
+
+//
+// W_PrefetchLumps
+// Lets the OS read a set of lumps in the background, for data that is
+// going to be loaded shortly, e.g. the next level's map lumps.
+//
+
+void W_PrefetchLumps(const lumpindex_t *lumps, int count)
+{
+    lumpinfo_t *l;
+    int i;
+
+    for (i = 0; i < count; ++i)
+    {
+        if ((unsigned) lumps[i] < numlumps)
+        {
+            l = lumpinfo[lumps[i]];
+            W_Prefetch(l->wad_file, l->position, l->size);
+        }
+    }
+}
+
+
 //
 // W_CacheLumpName
 //
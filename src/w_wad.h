@@ -68,6 +68,8 @@ void W_ReadLump(lumpindex_t lump, void *dest);
 
 void *W_CacheLumpNum(lumpindex_t lumpnum, int tag);
 void *W_CacheLumpName(char *name, int tag);
+void W_CacheLumps(const lumpindex_t *lumps, int count, int tag);
+void W_PrefetchLumps(const lumpindex_t *lumps, int count);
 
 void W_GenerateHashTable(void);
 
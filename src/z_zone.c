@@ -38,6 +38,13 @@
 //
 // It is of no value to free a cachable block,
 //  because it will get overwritten automatically if needed.
+//
+// [JN] Free blocks are also kept in segregated free lists, one per
+//  power of two size class. Z_Malloc takes the first fitting block from
+//  the smallest class that has one, and only falls back to the rover
+//  walk, which throws out purgable blocks, when no free block is big
+//  enough. The links live in the body of the free block, so the block
+//  header and the tag/user semantics are unchanged.
 // 
  
 #define MEM_ALIGN sizeof(void *)
@@ -54,7 +61,22 @@ typedef struct memblock_s
 } memblock_t;
 
 
+// Free list links, stored in the body of a free block.
 typedef struct
+{
+    memblock_t*	next;
+    memblock_t*	prev;
+} freelink_t;
+
+#define FREELINK(block) ((freelink_t *) ((byte *)(block) + sizeof(memblock_t)))
+
+// Every block must be able to hold the links once freed.
+#define MINBLOCKSIZE (sizeof(memblock_t) + sizeof(freelink_t))
+
+// Size classes: bin n holds free blocks of 2^n to 2^(n+1)-1 bytes.
+#define NUMBINS 32
+
+typedef struct memzone_s
 {
     // total bytes malloced, including header
     int		size;
@@ -63,6 +85,9 @@ typedef struct
     memblock_t	blocklist;
     
     memblock_t*	rover;
+
+    // [JN] zone that was the main one before Z_Init grew the heap
+    struct memzone_s*	older;
     
 } memzone_t;
 
@@ -72,6 +97,91 @@ static memzone_t *mainzone;
 static boolean zero_on_free;
 static boolean scan_on_free;
 
+// Heads of the free lists and a bit for each non-empty one. Blocks of
+// zones left behind by Z_Init stay in the lists and are reused, so
+// everything that walks blocks has to walk every zone, mainzone first
+// and then down the older links.
+static memblock_t *freebins[NUMBINS];
+static unsigned int freebinmask;
+
+
+static void Z_CheckGrowth (void);
+
+static int Z_SizeBin (int size)
+{
+    int bin = 0;
+
+    while (size >>= 1)
+        bin++;
+
+    return bin;
+}
+
+static void Z_InsertFree (memblock_t* block)
+{
+    int		bin = Z_SizeBin(block->size);
+    freelink_t*	link = FREELINK(block);
+
+    link->prev = NULL;
+    link->next = freebins[bin];
+
+    if (link->next)
+        FREELINK(link->next)->prev = block;
+
+    freebins[bin] = block;
+    freebinmask |= 1u << bin;
+}
+
+static void Z_RemoveFree (memblock_t* block)
+{
+    int		bin = Z_SizeBin(block->size);
+    freelink_t*	link = FREELINK(block);
+
+    if (link->prev)
+        FREELINK(link->prev)->next = link->next;
+    else
+        freebins[bin] = link->next;
+
+    if (link->next)
+        FREELINK(link->next)->prev = link->prev;
+
+    if (!freebins[bin])
+        freebinmask &= ~(1u << bin);
+}
+
+//
+// Z_FindFree
+// Smallest size class first, first fit within the class. Every block
+// of a bigger class fits, so only the first class needs a scan.
+//
+static memblock_t* Z_FindFree (int size)
+{
+    int		bin = Z_SizeBin(size);
+    unsigned int mask;
+    memblock_t*	block;
+
+    for (block = freebins[bin]; block; block = FREELINK(block)->next)
+    {
+        if (block->size >= size)
+            return block;
+    }
+
+    mask = bin + 1 < NUMBINS ? freebinmask >> (bin + 1) : 0;
+
+    if (!mask)
+        return NULL;
+
+    bin++;
+
+    while (!(mask & 1))
+    {
+        mask >>= 1;
+        bin++;
+    }
+
+    return freebins[bin];
+}
+
 
 //
 // Z_ClearZone
@@ -95,6 +205,10 @@ void Z_ClearZone (memzone_t* zone)
     block->tag = PU_FREE;
 
     block->size = zone->size - sizeof(memzone_t);
+
+    memset(freebins, 0, sizeof(freebins));
+    freebinmask = 0;
+    Z_InsertFree(block);
 }
 
 
@@ -105,10 +219,12 @@ void Z_ClearZone (memzone_t* zone)
 void Z_Init (void)
 {
     memblock_t*	block;
+    memzone_t*	older = mainzone;
     int		size;
 
     mainzone = (memzone_t *)I_ZoneBase (&size);
     mainzone->size = size;
+    mainzone->older = older;
 
     // set the entire zone to one free block
     mainzone->blocklist.next =
@@ -126,6 +242,8 @@ void Z_Init (void)
 
     block->size = mainzone->size - sizeof(memzone_t);
 
+    Z_InsertFree(block);
+
     // [Deliberately undocumented]
     // Zone memory debugging flag. If set, memory is zeroed after it is freed
     // to deliberately break any code that attempts to use it after free.
@@ -137,19 +255,31 @@ void Z_Init (void)
     // heap is scanned to look for remaining pointers to the freed block.
     //
     scan_on_free = M_ParmExists("-zonescan");
+
+    // [Deliberately undocumented]
+    // Zone memory debugging flag. If set, the heap is grown once at startup
+    // and Z_FreeTags is checked to free PU_LEVEL blocks in every zone.
+    //
+    if (older == NULL && M_ParmExists("-zonecheck"))
+    {
+        Z_CheckGrowth();
+    }
 }
 
 // Scan the zone heap for pointers within the specified range, and warn about
 // any remaining pointers.
 static void ScanForBlock(void *start, void *end)
 {
+    memzone_t *zone;
     memblock_t *block;
     void **mem;
     int i, len, tag;
 
-    block = mainzone->blocklist.next;
+    for (zone = mainzone; zone != NULL; zone = zone->older)
+    {
+    block = zone->blocklist.next;
 
-    while (block->next != &mainzone->blocklist)
+    while (block->next != &zone->blocklist)
     {
         tag = block->tag;
 
@@ -174,6 +304,7 @@ static void ScanForBlock(void *start, void *end)
 
         block = block->next;
     }
+    }
 }
 
 //
@@ -219,6 +350,7 @@ void Z_Free (void* ptr)
     if (other->tag == PU_FREE)
     {
         // merge with previous free block
+        Z_RemoveFree(other);
         other->size += block->size;
         other->next = block->next;
         other->next->prev = other;
@@ -233,6 +365,7 @@ void Z_Free (void* ptr)
     if (other->tag == PU_FREE)
     {
         // merge the next free block onto the end
+        Z_RemoveFree(other);
         block->size += other->size;
         block->next = other->next;
         block->next->prev = block;
@@ -240,10 +373,47 @@ void Z_Free (void* ptr)
         if (other == mainzone->rover)
             mainzone->rover = block;
     }
+
+    Z_InsertFree(block);
 }
 
 
 
+//
+// Z_PurgeOlderZones
+// [JN] The rover only walks mainzone, so purgable blocks left in older
+//  zones are thrown out here. Returns true if anything was freed.
+//
+static boolean Z_PurgeOlderZones (void)
+{
+    memzone_t*	zone;
+    memblock_t*	block;
+    memblock_t*	next;
+    boolean	purged = false;
+
+    for (zone = mainzone->older; zone != NULL; zone = zone->older)
+    {
+        for (block = zone->blocklist.next;
+             block != &zone->blocklist;
+             block = next)
+        {
+            next = block->next;
+
+            if (block->tag >= PU_PURGELEVEL)
+            {
+                // the merge in Z_Free can swallow the next block,
+                //  step back to the previous one to stay in the list
+                next = block->prev;
+                Z_Free((byte *)block + sizeof(memblock_t));
+                next = next->next;
+                purged = true;
+            }
+        }
+    }
+
+    return purged;
+}
+
 //
 // Z_Malloc
 // You can pass a NULL user if the tag is < PU_PURGELEVEL.
@@ -262,6 +432,8 @@ Z_Malloc
     memblock_t* rover;
     memblock_t* newblock;
     memblock_t*	base;
+    boolean	walked;
+    boolean	purged;
     void *result;
 
     size = (size + MEM_ALIGN - 1) & ~(MEM_ALIGN - 1);
@@ -273,7 +445,22 @@ Z_Malloc
 
     // account for size of block header
     size += sizeof(memblock_t);
-    
+
+    // [JN] room for the free list links once freed
+    if (size < MINBLOCKSIZE)
+        size = MINBLOCKSIZE;
+
+    // [JN] take a free block if there is one big enough,
+    //  nothing has to be purged then
+    base = Z_FindFree(size);
+    walked = false;
+
+    if (base)
+        goto found;
+
+    walked = true;
+    purged = false;
+
     // if there is a free block behind the rover,
     //  back up over them
     base = mainzone->rover;
@@ -291,6 +478,19 @@ Z_Malloc
             // scanned all the way around the list
 //          I_Error ("Z_Malloc: failed on allocation of %i bytes", size);
 
+            // [JN] purgable blocks in older zones may make room first
+            if (!purged)
+            {
+                purged = true;
+
+                if (Z_PurgeOlderZones() && (base = Z_FindFree(size)) != NULL)
+                {
+                    walked = false;
+                    goto found;
+                }
+
+            }
+
             // [crispy] allocate another zone twice as big
             Z_Init();
 
@@ -325,8 +525,9 @@ Z_Malloc
 
     } while (base->tag != PU_FREE || base->size < size);
 
-    
+  found:
     // found a block big enough
+    Z_RemoveFree(base);
     extra = base->size - size;
     
     if (extra >  MINFRAGMENT)
@@ -337,12 +538,15 @@ Z_Malloc
 	
         newblock->tag = PU_FREE;
         newblock->user = NULL;	
+        newblock->id = 0;
         newblock->prev = base;
         newblock->next = base->next;
         newblock->next->prev = newblock;
 
         base->next = newblock;
         base->size = size;
+
+        Z_InsertFree(newblock);
     }
 	
 	if (user == NULL && tag >= PU_PURGELEVEL)
@@ -361,7 +565,10 @@ Z_Malloc
     }
 
     // next allocation will start looking here
-    mainzone->rover = base->next;	
+    // [JN] only when it came from the rover walk, blocks from the free
+    //  lists may belong to an older zone
+    if (walked)
+        mainzone->rover = base->next;	
 	
     base->id = ZONEID;
    
@@ -371,18 +578,15 @@ Z_Malloc
 
 
 //
-// Z_FreeTags
+// Z_FreeZoneTags
 //
-void
-Z_FreeTags
-( int		lowtag,
-  int		hightag )
+static void Z_FreeZoneTags (memzone_t* zone, int lowtag, int hightag)
 {
     memblock_t*	block;
     memblock_t*	next;
 	
-    for (block = mainzone->blocklist.next ;
-	 block != &mainzone->blocklist ;
+    for (block = zone->blocklist.next ;
+	 block != &zone->blocklist ;
 	 block = next)
     {
 	// get link before freeing
@@ -397,6 +601,21 @@ Z_FreeTags
     }
 }
 
+//
+// Z_FreeTags
+// [JN] Blocks of older zones are still handed out, free them as well.
+//
+void
+Z_FreeTags
+( int		lowtag,
+  int		hightag )
+{
+    memzone_t*	zone;
+
+    for (zone = mainzone; zone != NULL; zone = zone->older)
+	Z_FreeZoneTags(zone, lowtag, hightag);
+}
+
 
 
 //
@@ -408,19 +627,22 @@ Z_DumpHeap
 ( int		lowtag,
   int		hightag )
 {
+    memzone_t*	zone;
     memblock_t*	block;
 	
-    printf (english_language ?
-        "zone size: %i  location: %p\n" :
-        "размер зоны: %i  расположение: %p\n",
-	    mainzone->size,mainzone);
-    
     printf (english_language ?
         "tag range: %i to %i\n" :
         "диапазон тегов: %i to %i\n",
 	    lowtag, hightag);
 	
-    for (block = mainzone->blocklist.next ; ; block = block->next)
+    for (zone = mainzone; zone != NULL; zone = zone->older)
+    {
+    printf (english_language ?
+        "zone size: %i  location: %p\n" :
+        "размер зоны: %i  расположение: %p\n",
+	    zone->size,zone);
+    
+    for (block = zone->blocklist.next ; ; block = block->next)
     {
 	if (block->tag >= lowtag && block->tag <= hightag)
 	    printf (english_language ?
@@ -428,7 +650,7 @@ Z_DumpHeap
                 "блок:%p    размер:%7i    пользователь:%p    тег:%3i\n",
                 block, block->size, block->user, block->tag);
 		
-	if (block->next == &mainzone->blocklist)
+	if (block->next == &zone->blocklist)
 	{
 	    // all blocks have been hit
 	    break;
@@ -449,6 +671,70 @@ Z_DumpHeap
                 "ERROR: two consecutive free blocks\n" :
                 "ОШИБКА: два последовательных свободных блока\n");
     }
+    }
+}
+
+
+//
+// Z_FileDumpFragmentation
+// [JN] Free list statistics: how much free memory there is and how
+//  much of it is usable for one big allocation.
+//
+static void Z_FileDumpFragmentation (FILE* f)
+{
+    memzone_t*	zone;
+    memblock_t*	block;
+    int		bin;
+    int		count, total;
+    int		numfree = 0;
+    int		totalfree = 0;
+    int		largest = 0;
+    int		purgable = 0;
+
+    for (bin = 0; bin < NUMBINS; bin++)
+    {
+        count = total = 0;
+
+        for (block = freebins[bin]; block; block = FREELINK(block)->next)
+        {
+            count++;
+            total += block->size;
+
+            if (block->size > largest)
+                largest = block->size;
+        }
+
+        if (count)
+            fprintf (f, english_language ?
+                        "free bin %2i (%9u+ bytes): %6i blocks %10i bytes\n" :
+                        "свободный класс %2i (%9u+ байт): %6i блоков %10i байт\n",
+                        bin, 1u << bin, count, total);
+
+        numfree += count;
+        totalfree += total;
+    }
+
+    for (zone = mainzone; zone != NULL; zone = zone->older)
+    {
+        for (block = zone->blocklist.next ;
+             block != &zone->blocklist;
+             block = block->next)
+        {
+            if (block->tag >= PU_PURGELEVEL)
+                purgable += block->size;
+        }
+    }
+
+    fprintf (f, english_language ?
+                "free: %i bytes in %i blocks, largest %i, purgable %i\n" :
+                "свободно: %i байт в %i блоках, наибольший %i, очищаемо %i\n",
+                totalfree, numfree, largest, purgable);
+
+    // share of free memory outside the largest free block
+    fprintf (f, english_language ?
+                "fragmentation: %.1f%%\n" :
+                "фрагментация: %.1f%%\n",
+                totalfree ? 100.0 - 100.0 * largest / totalfree : 0.0);
 }
 
 
@@ -457,21 +743,24 @@ Z_DumpHeap
 //
 void Z_FileDumpHeap (FILE* f)
 {
+    memzone_t*	zone;
     memblock_t*	block;
 	
+    for (zone = mainzone; zone != NULL; zone = zone->older)
+    {
     fprintf (f, english_language ?
                 "zone size: %i  location: %p\n" :
                 "размер зоны: %i  расположение: %p\n",
-                mainzone->size,mainzone);
+                zone->size,zone);
 	
-    for (block = mainzone->blocklist.next ; ; block = block->next)
+    for (block = zone->blocklist.next ; ; block = block->next)
     {
 	fprintf (f, english_language ?
                 "block:%p    size:%7i    user:%p    tag:%3i\n" :
                 "блок:%p    размер:%7i    пользователь:%p    тег:%3i\n",
 		 block, block->size, block->user, block->tag);
 		
-	if (block->next == &mainzone->blocklist)
+	if (block->next == &zone->blocklist)
 	{
 	    // all blocks have been hit
 	    break;
@@ -492,6 +781,9 @@ void Z_FileDumpHeap (FILE* f)
                     "ERROR: two consecutive free blocks\n" :
                     "ОШИБКА: два последовательных свободных блока\n");
     }
+    }
+
+    Z_FileDumpFragmentation(f);
 }
 
 
@@ -501,11 +793,14 @@ void Z_FileDumpHeap (FILE* f)
 //
 void Z_CheckHeap (void)
 {
+    memzone_t*	zone;
     memblock_t*	block;
 	
-    for (block = mainzone->blocklist.next ; ; block = block->next)
+    for (zone = mainzone; zone != NULL; zone = zone->older)
+    {
+    for (block = zone->blocklist.next ; ; block = block->next)
     {
-	if (block->next == &mainzone->blocklist)
+	if (block->next == &zone->blocklist)
 	{
 	    // all blocks have been hit
 	    break;
@@ -526,6 +821,7 @@ void Z_CheckHeap (void)
                  "Z_CheckHeap: two consecutive free blocks\n" :
                  "Z_CheckHeap: два последовательных свободных блока\n");
     }
+    }
 }
 
 
@@ -578,17 +874,21 @@ void Z_ChangeUser(void *ptr, void **user)
 //
 int Z_FreeMemory (void)
 {
+    memzone_t*		zone;
     memblock_t*		block;
     int			free;
 	
     free = 0;
     
-    for (block = mainzone->blocklist.next ;
-         block != &mainzone->blocklist;
-         block = block->next)
+    for (zone = mainzone; zone != NULL; zone = zone->older)
     {
-        if (block->tag == PU_FREE || block->tag >= PU_PURGELEVEL)
-            free += block->size;
+        for (block = zone->blocklist.next ;
+             block != &zone->blocklist;
+             block = block->next)
+        {
+            if (block->tag == PU_FREE || block->tag >= PU_PURGELEVEL)
+                free += block->size;
+        }
     }
 
     return free;
@@ -596,7 +896,71 @@ int Z_FreeMemory (void)
 
 unsigned int Z_ZoneSize(void)
 {
-    return mainzone->size;
+    memzone_t*	zone;
+    unsigned int size = 0;
+
+    for (zone = mainzone; zone != NULL; zone = zone->older)
+        size += zone->size;
+
+    return size;
+}
+
+//
+// Z_CheckGrowth
+// [JN] -zonecheck: allocate PU_LEVEL blocks until the heap has grown
+//  past its first zone, free the level's tags and make sure nothing
+//  of the level is left in any zone.
+//
+static void Z_CheckGrowth (void)
+{
+    memzone_t*	zone;
+    memblock_t*	block;
+    memzone_t*	first = mainzone;
+    void*	users[64];
+    int		count = 0;
+    int		i;
+
+    memset(users, 0, sizeof(users));
+
+    // fill the first zone, the last blocks go to the new one
+    while (mainzone == first && count < (int) arrlen(users) - 1)
+    {
+        Z_Malloc(first->size / 8, PU_LEVEL, &users[count++]);
+    }
+
+    // one more after the growth so both zones hold level blocks
+    Z_Malloc(first->size / 8, PU_LEVSPEC, &users[count++]);
+
+    if (mainzone == first)
+        I_Error (english_language ?
+                 "Z_CheckGrowth: zone did not grow" :
+                 "Z_CheckGrowth: зона не была увеличена");
+
+    Z_FreeTags(PU_LEVEL, PU_PURGELEVEL - 1);
+
+    for (i = 0; i < count; i++)
+    {
+        if (users[i] != NULL)
+            I_Error (english_language ?
+                     "Z_CheckGrowth: user of block %i was not cleared" :
+                     "Z_CheckGrowth: пользователь блока %i не был очищен", i);
+    }
+
+    for (zone = mainzone; zone != NULL; zone = zone->older)
+    {
+        for (block = zone->blocklist.next;
+             block != &zone->blocklist;
+             block = block->next)
+        {
+            if (block->tag >= PU_LEVEL && block->tag < PU_PURGELEVEL)
+                I_Error (english_language ?
+                         "Z_CheckGrowth: level block %p left in zone %p" :
+                         "Z_CheckGrowth: блок уровня %p остался в зоне %p",
+                         block, zone);
+        }
+    }
+
+    Z_CheckHeap();
 }
 
 void *crispy_realloc(void *ptr, size_t size)